@@ -270,3 +270,119 @@ TEST (active_transactions, prioritize_chains)
 	ASSERT_LT (seen, 2);
 	ASSERT_EQ (node1.active.size (), 4);
 }
+
+TEST (active_transactions, admission_queue)
+{
+	nano::system system;
+	nano::node_config node_config (24000, system.logging);
+	node_config.enable_voting = false;
+	node_config.active_elections_size = 1;
+	node_config.active_elections_queue_size = 1;
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto & node1 = *system.add_node (node_config);
+	nano::genesis genesis;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::xrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::xrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1->hash ())));
+	auto send3 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send2->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 3 * nano::xrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send2->hash ())));
+	ASSERT_EQ (nano::process_result::progress, node1.process (*send1).code);
+	ASSERT_EQ (nano::process_result::progress, node1.process (*send2).code);
+	ASSERT_EQ (nano::process_result::progress, node1.process (*send3).code);
+	ASSERT_EQ (nano::election_start_result::started, node1.active.start (send1));
+	ASSERT_EQ (1, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_admitted));
+	// No room and nothing can be dropped yet, so send2 waits and is not reported as started
+	ASSERT_EQ (nano::election_start_result::queued, node1.active.start (send2));
+	ASSERT_EQ (1, node1.active.size ());
+	ASSERT_EQ (1, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_queued));
+	// Queue is bounded to a single candidate, the lower priority one is evicted
+	ASSERT_NE (nano::election_start_result::started, node1.active.start (send3));
+	ASSERT_EQ (1, node1.active.size ());
+	ASSERT_EQ (2, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_queued));
+	ASSERT_EQ (1, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_evicted));
+	// Once send1 is long unconfirmed it is dropped and the remaining candidate takes its place
+	system.deadline_set (10s);
+	while (node1.stats.count (nano::stat::type::election, nano::stat::detail::election_admitted) < 2)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, node1.active.size ());
+	ASSERT_LE (1, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_dropped));
+	ASSERT_EQ (1, node1.stats.count (nano::stat::type::election, nano::stat::detail::election_queue_age_1s) + node1.stats.count (nano::stat::type::election, nano::stat::detail::election_queue_age_10s));
+}
+
+TEST (active_transactions, request_wheel)
+{
+	nano::request_wheel wheel (4);
+	nano::qualified_root root1 (nano::block_hash (1), nano::block_hash (1));
+	nano::qualified_root root2 (nano::block_hash (2), nano::block_hash (2));
+	nano::qualified_root root3 (nano::block_hash (3), nano::block_hash (3));
+	wheel.schedule (root1, 1);
+	wheel.schedule (root2, 3);
+	// Further ahead than the wheel spans
+	wheel.schedule (root3, 6);
+	ASSERT_EQ (3, wheel.size ());
+	ASSERT_EQ (1, wheel.overflow_size ());
+	std::deque<nano::qualified_root> due;
+	wheel.advance (due);
+	ASSERT_EQ (1, due.size ());
+	ASSERT_EQ (root1, due.front ());
+	due.clear ();
+	wheel.advance (due);
+	ASSERT_TRUE (due.empty ());
+	ASSERT_EQ (0, wheel.overflow_size ());
+	wheel.advance (due);
+	ASSERT_EQ (1, due.size ());
+	ASSERT_EQ (root2, due.front ());
+	due.clear ();
+	for (auto i (0); i < 2; ++i)
+	{
+		wheel.advance (due);
+		ASSERT_TRUE (due.empty ());
+	}
+	wheel.advance (due);
+	ASSERT_EQ (1, due.size ());
+	ASSERT_EQ (root3, due.front ());
+	ASSERT_EQ (0, wheel.size ());
+}
+
+TEST (active_transactions, active_difficulty_median)
+{
+	nano::system system;
+	nano::node_config node_config (24000, system.logging);
+	node_config.enable_voting = false;
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto & node1 = *system.add_node (node_config);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - 10 * nano::xrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 20 * nano::xrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1->hash ())));
+	auto send3 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send2->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 30 * nano::xrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send2->hash ())));
+	// Median of the adjusted difficulties of all elections except the one for the given root
+	auto expected_multiplier = [&node1](nano::qualified_root const & excluded_a) {
+		std::vector<uint64_t> difficulties;
+		for (auto & root : node1.active.roots.get<1> ())
+		{
+			if (root.root != excluded_a)
+			{
+				difficulties.push_back (root.adjusted_difficulty);
+			}
+		}
+		return nano::difficulty::to_multiplier (difficulties[difficulties.size () / 2], node1.network_params.network.publish_threshold);
+	};
+	node1.active.start (send1);
+	node1.active.start (send2);
+	std::this_thread::sleep_for (std::chrono::milliseconds (node1.network_params.network.request_interval_ms * 2));
+	{
+		std::unique_lock<std::mutex> lock (node1.active.mutex);
+		ASSERT_EQ (2, node1.active.roots.size ());
+		node1.active.update_active_difficulty (lock);
+		ASSERT_DOUBLE_EQ (expected_multiplier (send3->qualified_root ()), node1.active.multipliers_cb.front ());
+	}
+	// Elections younger than a request interval do not count yet
+	node1.active.start (send3);
+	{
+		std::unique_lock<std::mutex> lock (node1.active.mutex);
+		ASSERT_EQ (3, node1.active.roots.size ());
+		node1.active.update_active_difficulty (lock);
+		ASSERT_DOUBLE_EQ (expected_multiplier (send3->qualified_root ()), node1.active.multipliers_cb.front ());
+	}
+}
@@ -433,6 +433,56 @@ TEST (block_uniquer, cleanup)
 	}
 }
 
+TEST (block_uniquer, hits)
+{
+	nano::keypair key;
+	auto block1 (std::make_shared<nano::state_block> (0, 0, 0, 0, 0, key.prv, key.pub, 0));
+	nano::block_uniquer uniquer;
+	ASSERT_EQ (nullptr, uniquer.find (block1->full_hash ()));
+	ASSERT_EQ (0, uniquer.hits ());
+	uniquer.unique (block1);
+	ASSERT_EQ (0, uniquer.hits ());
+	ASSERT_EQ (1, uniquer.misses ());
+	uniquer.unique (std::make_shared<nano::state_block> (*block1));
+	ASSERT_EQ (block1, uniquer.find (block1->full_hash ()));
+	ASSERT_EQ (2, uniquer.hits ());
+	ASSERT_EQ (1, uniquer.misses ());
+}
+
+TEST (block_uniquer, concurrent)
+{
+	nano::keypair key;
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	for (auto i (0); i < 64; ++i)
+	{
+		blocks.push_back (std::make_shared<nano::state_block> (0, 0, 0, 0, 0, key.prv, key.pub, i));
+	}
+	nano::block_uniquer uniquer;
+	for (auto & block : blocks)
+	{
+		uniquer.unique (block);
+	}
+	std::vector<std::thread> threads;
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.emplace_back ([&uniquer, &blocks]() {
+			for (auto j (0); j < 100; ++j)
+			{
+				for (auto & block : blocks)
+				{
+					ASSERT_EQ (block, uniquer.unique (std::make_shared<nano::state_block> (static_cast<nano::state_block &> (*block))));
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	ASSERT_EQ (blocks.size (), uniquer.misses ());
+	ASSERT_EQ (4 * 100 * blocks.size (), uniquer.hits ());
+}
+
 TEST (block_builder, from)
 {
 	std::error_code ec;
@@ -1540,6 +1540,41 @@ TEST (block_store, online_weight)
 	ASSERT_EQ (store->online_weight_end (), store->online_weight_begin (transaction));
 }
 
+TEST (block_store, bootstrap_checkpoint)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_FALSE (store->init_error ());
+	nano::account account (1);
+	nano::pull_checkpoint pull (2, 3, 4, 5, 600);
+	nano::account cursor;
+	{
+		auto transaction (store->tx_begin_write ());
+		ASSERT_EQ (0, store->bootstrap_pull_count (transaction));
+		ASSERT_TRUE (store->bootstrap_frontier_get (transaction, cursor));
+		store->bootstrap_pull_put (transaction, account, pull);
+		store->bootstrap_frontier_put (transaction, nano::account (7));
+	}
+	{
+		auto transaction (store->tx_begin_write ());
+		ASSERT_EQ (1, store->bootstrap_pull_count (transaction));
+		auto item (store->bootstrap_pull_begin (transaction));
+		ASSERT_NE (store->bootstrap_pull_end (), item);
+		ASSERT_EQ (account, item->first);
+		ASSERT_EQ (pull, item->second);
+		ASSERT_FALSE (store->bootstrap_frontier_get (transaction, cursor));
+		ASSERT_EQ (nano::account (7), cursor);
+		store->bootstrap_pull_clear (transaction);
+		store->bootstrap_frontier_del (transaction);
+	}
+	auto transaction (store->tx_begin_read ());
+	ASSERT_EQ (0, store->bootstrap_pull_count (transaction));
+	ASSERT_EQ (store->bootstrap_pull_end (), store->bootstrap_pull_begin (transaction));
+	ASSERT_TRUE (store->bootstrap_frontier_get (transaction, cursor));
+	// The version entry shares the meta table
+	ASSERT_LT (0, store->version_get (transaction));
+}
+
 // Adding confirmation height to accounts
 TEST (mdb_block_store, upgrade_v13_v14)
 {
@@ -1653,6 +1688,37 @@ TEST (mdb_block_store, upgrade_v14_v15)
 	ASSERT_LT (14, store.version_get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v15_v16)
+{
+	// Add the bootstrap checkpoint table
+	auto path (nano::unique_path ());
+	{
+		nano::logger_mt logger;
+		nano::genesis genesis;
+		nano::mdb_store store (logger, path);
+		auto transaction (store.tx_begin_write ());
+		nano::rep_weights rep_weights;
+		store.initialize (transaction, genesis, rep_weights);
+
+		// Lower the database to the previous version
+		store.version_put (transaction, 15);
+		ASSERT_EQ (MDB_SUCCESS, mdb_drop (store.env.tx (transaction), store.bootstrap, 1));
+	}
+
+	// Now do the upgrade
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+
+	// The table should exist again
+	ASSERT_NE (store.bootstrap, 0);
+	ASSERT_EQ (0, store.bootstrap_pull_count (transaction));
+
+	// Version should be correct
+	ASSERT_LT (15, store.version_get (transaction));
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	auto dir (nano::unique_path ());
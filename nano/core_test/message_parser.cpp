@@ -11,17 +11,19 @@ public:
 	{
 		++keepalive_count;
 	}
-	void publish (nano::publish const &) override
+	void publish (nano::publish const & message_a) override
 	{
 		++publish_count;
+		last_block = message_a.block;
 	}
 	void confirm_req (nano::confirm_req const &) override
 	{
 		++confirm_req_count;
 	}
-	void confirm_ack (nano::confirm_ack const &) override
+	void confirm_ack (nano::confirm_ack const & message_a) override
 	{
 		++confirm_ack_count;
+		last_vote = message_a.vote;
 	}
 	void bulk_pull (nano::bulk_pull const &) override
 	{
@@ -52,6 +54,8 @@ public:
 	uint64_t bulk_push_count{ 0 };
 	uint64_t frontier_req_count{ 0 };
 	uint64_t node_id_handshake_count{ 0 };
+	std::shared_ptr<nano::block> last_block;
+	std::shared_ptr<nano::vote> last_vote;
 };
 }
 
@@ -214,3 +218,59 @@ TEST (message_parser, exact_keepalive_size)
 	ASSERT_EQ (1, visitor.keepalive_count);
 	ASSERT_NE (parser.status, nano::message_parser::parse_status::success);
 }
+
+TEST (message_parser, duplicate_publish)
+{
+	nano::system system (24000, 1);
+	test_visitor visitor;
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	nano::message_parser parser (block_uniquer, vote_uniquer, visitor, system.work);
+	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, system.work.generate (1)));
+	nano::publish message (block);
+	auto bytes (message.to_bytes ());
+	parser.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser.status, nano::message_parser::parse_status::success);
+	auto first (visitor.last_block);
+	ASSERT_NE (nullptr, first);
+	ASSERT_NE (block, first);
+	ASSERT_EQ (*block, *first);
+	parser.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser.status, nano::message_parser::parse_status::success);
+	ASSERT_EQ (2, visitor.publish_count);
+	// The duplicate is resolved to the live block without promoting another copy
+	ASSERT_EQ (first, visitor.last_block);
+	ASSERT_EQ (1, block_uniquer.size ());
+	// Once released, the block is decoded and promoted again
+	visitor.last_block.reset ();
+	first.reset ();
+	parser.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_NE (nullptr, visitor.last_block);
+	ASSERT_EQ (*block, *visitor.last_block);
+}
+
+TEST (message_parser, duplicate_confirm_ack)
+{
+	nano::system system (24000, 1);
+	test_visitor visitor;
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	nano::message_parser parser (block_uniquer, vote_uniquer, visitor, system.work);
+	nano::keypair key;
+	std::vector<nano::block_hash> hashes{ 1, 2, 3 };
+	auto vote1 (std::make_shared<nano::vote> (key.pub, key.prv, 1, hashes));
+	auto vote2 (std::make_shared<nano::vote> (key.pub, key.prv, 2, hashes));
+	auto bytes1 (nano::confirm_ack (vote1).to_bytes ());
+	auto bytes2 (nano::confirm_ack (vote2).to_bytes ());
+	parser.deserialize_buffer (bytes1->data (), bytes1->size ());
+	ASSERT_EQ (parser.status, nano::message_parser::parse_status::success);
+	auto first (visitor.last_vote);
+	ASSERT_EQ (*vote1, *first);
+	parser.deserialize_buffer (bytes1->data (), bytes1->size ());
+	ASSERT_EQ (first, visitor.last_vote);
+	parser.deserialize_buffer (bytes2->data (), bytes2->size ());
+	ASSERT_EQ (3, visitor.confirm_ack_count);
+	ASSERT_NE (first, visitor.last_vote);
+	ASSERT_EQ (*vote2, *visitor.last_vote);
+	ASSERT_EQ (2, vote_uniquer.size ());
+}
@@ -1,4 +1,5 @@
 #include <nano/core_test/testutil.hpp>
+#include <nano/crypto_lib/random_pool.hpp>
 #include <nano/node/testing.hpp>
 #include <nano/node/transport/udp.hpp>
 
@@ -319,6 +320,84 @@ TEST (network, send_valid_publish)
 	}
 }
 
+// Messages sent back to back over a realtime connection are read in chunks and dispatched in batches
+TEST (network, tcp_realtime_batch)
+{
+	nano::system system (24000, 2, nano::transport::transport_type::tcp);
+	auto & node0 (*system.nodes[0]);
+	auto & node1 (*system.nodes[1]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	nano::publish publish (send1);
+	auto channel (node1.network.find_channel (node0.network.endpoint ()));
+	ASSERT_NE (nullptr, channel);
+	auto initial (node0.stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in));
+	size_t const count (50);
+	for (size_t i (0); i < count; ++i)
+	{
+		channel->send (publish);
+	}
+	system.deadline_set (10s);
+	while (node0.stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in) < initial + count)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	auto messages (node0.stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_read_message, nano::stat::dir::in));
+	ASSERT_GE (messages, count);
+	ASSERT_LE (node0.stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_read_batch, nano::stat::dir::in), messages);
+}
+
+TEST (network, fanout_representatives)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	std::vector<std::shared_ptr<nano::transport::channel>> channels;
+	for (uint16_t i (0); i < 16; ++i)
+	{
+		auto channel (node.network.udp_channels.insert (nano::endpoint (node.network.endpoint ().address (), 24100 + i), node.network_params.protocol.protocol_version));
+		ASSERT_NE (nullptr, channel);
+		channels.push_back (channel);
+	}
+	ASSERT_EQ (4, node.network.size_sqrt ());
+	nano::keypair rep;
+	node.rep_crawler.response (channels[5], rep.pub, nano::amount (100));
+	for (auto i (0); i < 100; ++i)
+	{
+		auto fanout (node.network.list_fanout ());
+		ASSERT_EQ (4, fanout.size ());
+		ASSERT_EQ (fanout.size (), std::unordered_set<std::shared_ptr<nano::transport::channel>> (fanout.begin (), fanout.end ()).size ());
+		// The only rep always takes one of the representative slots
+		ASSERT_NE (fanout.end (), std::find (fanout.begin (), fanout.end (), channels[5]));
+	}
+}
+
+TEST (network, duplicate_filter)
+{
+	nano::duplicate_filter filter (1024);
+	nano::keypair key;
+	auto block1 (std::make_shared<nano::state_block> (0, 0, 0, 0, 0, key.prv, key.pub, 0));
+	auto block2 (std::make_shared<nano::state_block> (0, 0, 0, 0, 0, key.prv, key.pub, 1));
+	ASSERT_FALSE (filter.apply (block1->block_signature ()));
+	ASSERT_TRUE (filter.apply (block1->block_signature ()));
+	ASSERT_FALSE (filter.apply (block2->block_signature ()));
+}
+
+TEST (network, duplicate_publish_stat)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	nano::publish publish (send1);
+	auto channel (node.network.udp_channels.create (node.network.endpoint ()));
+	node.network.process_message (publish, channel);
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::duplicate, nano::stat::detail::publish, nano::stat::dir::in));
+	node.network.process_message (publish, channel);
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::duplicate, nano::stat::detail::publish, nano::stat::dir::in));
+}
+
 TEST (network, send_insufficient_work)
 {
 	nano::system system (24000, 2);
@@ -627,6 +706,52 @@ TEST (bulk_pull, count_limit)
 	ASSERT_EQ (nullptr, block);
 }
 
+TEST (bulk_pull, read_window)
+{
+	nano::system system;
+	nano::node_config config (24000, system.logging);
+	config.bootstrap_serving_window = 2;
+	auto node (system.add_node (config));
+	auto send1 (std::make_shared<nano::send_block> (node->latest (nano::test_genesis_key.pub), nano::test_genesis_key.pub, 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (node->latest (nano::test_genesis_key.pub))));
+	ASSERT_EQ (nano::process_result::progress, node->process (*send1).code);
+	auto receive1 (std::make_shared<nano::receive_block> (send1->hash (), send1->hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1->hash ())));
+	ASSERT_EQ (nano::process_result::progress, node->process (*receive1).code);
+
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, node));
+	std::unique_ptr<nano::bulk_pull> req (new nano::bulk_pull{});
+	req->start = nano::test_genesis_key.pub;
+	req->end.clear ();
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::bulk_pull_server> (connection, std::move (req)));
+	// First window holds two blocks and no terminator
+	request->read_window ();
+	ASSERT_FALSE (request->next_last);
+	{
+		nano::bufferstream stream (request->next_buffer->data (), request->next_buffer->size ());
+		auto block1 (nano::deserialize_block (stream));
+		ASSERT_NE (nullptr, block1);
+		ASSERT_EQ (receive1->hash (), block1->hash ());
+		auto block2 (nano::deserialize_block (stream));
+		ASSERT_NE (nullptr, block2);
+		ASSERT_EQ (send1->hash (), block2->hash ());
+		uint8_t junk;
+		ASSERT_TRUE (nano::try_read (stream, junk));
+	}
+	// Second window ends the chain with the genesis open block and not_a_block
+	request->read_window ();
+	ASSERT_TRUE (request->next_last);
+	{
+		nano::bufferstream stream (request->next_buffer->data (), request->next_buffer->size ());
+		auto block3 (nano::deserialize_block (stream));
+		ASSERT_NE (nullptr, block3);
+		ASSERT_EQ (nano::genesis ().hash (), block3->hash ());
+		uint8_t type (0);
+		ASSERT_FALSE (nano::try_read (stream, type));
+		ASSERT_EQ (static_cast<uint8_t> (nano::block_type::not_a_block), type);
+		ASSERT_TRUE (nano::try_read (stream, type));
+	}
+}
+
 TEST (bootstrap_processor, DISABLED_process_none)
 {
 	nano::system system (24000, 1);
@@ -940,6 +1065,287 @@ TEST (bootstrap_processor, wallet_lazy_pending)
 	node1->stop ();
 }
 
+TEST (bootstrap_processor, wallet_lazy_pending_pipelined)
+{
+	nano::system system (24000, 1);
+	nano::genesis genesis;
+	std::vector<nano::keypair> keys (4);
+	std::vector<std::shared_ptr<nano::state_block>> sends;
+	auto previous (genesis.hash ());
+	auto balance (nano::genesis_amount);
+	// Generating one pending send to each wallet account
+	for (auto & key : keys)
+	{
+		balance -= nano::Gxrb_ratio;
+		auto send (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, balance, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.nodes[0]->work_generate_blocking (previous)));
+		system.nodes[0]->block_processor.add (send);
+		sends.push_back (send);
+		previous = send->hash ();
+	}
+	system.nodes[0]->block_processor.flush ();
+	// Start wallet lazy bootstrap, all accounts are requested over the same connection
+	auto node1 (std::make_shared<nano::node> (system.io_ctx, 24001, nano::unique_path (), system.alarm, system.logging, system.work));
+	node1->network.udp_channels.insert (system.nodes[0]->network.endpoint (), node1->network_params.protocol.protocol_version);
+	auto wallet (node1->wallets.create (nano::uint256_union ()));
+	ASSERT_NE (nullptr, wallet);
+	for (auto & key : keys)
+	{
+		wallet->insert_adhoc (key.prv);
+	}
+	node1->bootstrap_wallet ();
+	// Check processed blocks
+	system.deadline_set (10s);
+	while (!std::all_of (sends.begin (), sends.end (), [&node1](std::shared_ptr<nano::state_block> const & send_a) { return node1->ledger.block_exists (send_a->hash ()); }))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	node1->stop ();
+}
+
+TEST (bootstrap_processor, checkpoint_resume)
+{
+	nano::system system (24000, 1);
+	auto node (system.nodes[0]);
+	auto attempt (std::make_shared<nano::bootstrap_attempt> (node));
+	std::vector<nano::pull_info> pulls;
+	for (auto i (1); i <= 3; ++i)
+	{
+		pulls.emplace_back (nano::account (i), nano::block_hash (i), nano::block_hash (0));
+	}
+	attempt->add_pulls (pulls, nano::account (3), nano::account (0), false);
+	// A pull being served is checkpointed as well
+	attempt->pulls_in_flight[nano::account (4)] = nano::pull_info (nano::account (4), nano::block_hash (4), nano::block_hash (0));
+	ASSERT_TRUE (attempt->checkpoint ());
+	{
+		auto transaction (node->store.tx_begin_read ());
+		ASSERT_EQ (4, node->store.bootstrap_pull_count (transaction));
+		nano::account cursor;
+		ASSERT_FALSE (node->store.bootstrap_frontier_get (transaction, cursor));
+		ASSERT_EQ (nano::account (3), cursor);
+	}
+	auto attempt2 (std::make_shared<nano::bootstrap_attempt> (node));
+	attempt2->resume ();
+	ASSERT_EQ (4, attempt2->pulls.size ());
+	ASSERT_EQ (nano::account (3), attempt2->frontier_cursor);
+	ASSERT_FALSE (attempt2->frontiers_complete);
+	// Completing the pulls removes the checkpoint
+	attempt2->clear_checkpoint ();
+	ASSERT_FALSE (attempt2->checkpoint ());
+	auto transaction (node->store.tx_begin_read ());
+	ASSERT_EQ (0, node->store.bootstrap_pull_count (transaction));
+	nano::account cursor;
+	ASSERT_TRUE (node->store.bootstrap_frontier_get (transaction, cursor));
+	attempt->stop ();
+	attempt2->stop ();
+}
+
+TEST (bootstrap_processor, frontier_ranges)
+{
+	nano::system system;
+	nano::node_config config (24000, system.logging);
+	config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	nano::node_flags node_flags;
+	node_flags.disable_legacy_bootstrap = true;
+	auto node0 (system.add_node (config, node_flags));
+	config.peering_port = 24001;
+	config.bootstrap_connections = 2;
+	auto node1 (system.add_node (config, node_flags));
+	// Identical frontiers on both nodes, the first of the two ranges holds more than one 16K frontier_req chunk
+	size_t const chunk (16 * 1024);
+	std::vector<nano::account> accounts;
+	for (size_t i (0); i < chunk + 200; ++i)
+	{
+		nano::account account;
+		nano::random_pool::generate_block (account.bytes.data (), account.bytes.size ());
+		if (i < chunk + 100)
+		{
+			account.bytes[0] &= 0x7f;
+		}
+		else
+		{
+			account.bytes[0] |= 0x80;
+		}
+		accounts.push_back (account);
+	}
+	for (auto & node : system.nodes)
+	{
+		auto transaction (node->store.tx_begin_write ());
+		for (auto & account : accounts)
+		{
+			node->store.account_put (transaction, account, { account, account, account, 1, nano::seconds_since_epoch (), 1, nano::epoch::epoch_0 });
+		}
+	}
+	auto attempt (std::make_shared<nano::bootstrap_attempt> (node1));
+	attempt->add_connection (node0->network.endpoint ());
+	attempt->add_connection (node0->network.endpoint ());
+	auto idle_size = [&attempt]() {
+		std::lock_guard<std::mutex> lock (attempt->mutex);
+		return attempt->idle.size ();
+	};
+	system.deadline_set (10s);
+	while (idle_size () < 2)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	std::atomic<bool> done{ false };
+	auto failed (true);
+	std::thread thread ([&attempt, &done, &failed]() {
+		std::unique_lock<std::mutex> lock (attempt->mutex);
+		failed = attempt->request_frontier (lock);
+		done = true;
+	});
+	system.deadline_set (10s);
+	while (!done)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	thread.join ();
+	ASSERT_FALSE (failed);
+	ASSERT_TRUE (attempt->frontiers_complete);
+	ASSERT_EQ (2, attempt->frontier_ranges.size ());
+	ASSERT_TRUE (attempt->pulls.empty ());
+	// Each range was requested over its own connection, the first range asked for a second chunk on its connection
+	ASSERT_EQ (2, node0->bootstrap.bootstrap_count);
+	ASSERT_EQ (3, node0->stats.count (nano::stat::type::bootstrap, nano::stat::detail::frontier_req, nano::stat::dir::in));
+	attempt->stop ();
+}
+
+TEST (bootstrap_processor, frontier_ranges_cursor)
+{
+	nano::system system (24000, 1);
+	auto node (system.nodes[0]);
+	auto attempt (std::make_shared<nano::bootstrap_attempt> (node));
+	attempt->frontier_ranges.push_back (nano::frontier_range{ nano::account (0), nano::account (100), false });
+	attempt->frontier_ranges.push_back (nano::frontier_range{ nano::account (99), nano::account (0), false });
+	// A later range completing first does not move the checkpointed cursor past an earlier incomplete one
+	attempt->add_pulls ({}, nano::account (200), nano::account (0), true);
+	ASSERT_EQ (nano::account (0), attempt->frontier_cursor);
+	ASSERT_FALSE (attempt->frontiers_complete);
+	attempt->add_pulls ({}, nano::account (50), nano::account (100), false);
+	ASSERT_EQ (nano::account (50), attempt->frontier_cursor);
+	ASSERT_FALSE (attempt->frontiers_complete);
+	attempt->add_pulls ({}, nano::account (99), nano::account (100), true);
+	ASSERT_TRUE (attempt->frontiers_complete);
+	attempt->stop ();
+}
+
+TEST (bootstrap_processor, steal_pull)
+{
+	nano::system system (24000, 1);
+	auto node (system.nodes[0]);
+	auto attempt (std::make_shared<nano::bootstrap_attempt> (node));
+	auto client1 (std::make_shared<nano::bootstrap_client> (node, attempt, std::make_shared<nano::transport::channel_tcp> (*node, std::make_shared<nano::socket> (node))));
+	auto client2 (std::make_shared<nano::bootstrap_client> (node, attempt, std::make_shared<nano::transport::channel_tcp> (*node, std::make_shared<nano::socket> (node))));
+	for (auto i (1); i <= 4; ++i)
+	{
+		client1->pulls.emplace_back (nano::account (i), nano::block_hash (i), nano::block_hash (0));
+	}
+	attempt->pulling = 4;
+	std::lock_guard<std::mutex> lock (attempt->mutex);
+	attempt->clients.push_back (client1);
+	attempt->clients.push_back (client2);
+	// The idle connection takes the back half of the busiest queue and starts on the first stolen pull
+	nano::pull_info pull;
+	ASSERT_TRUE (attempt->steal_pull (client2, pull));
+	ASSERT_EQ (nano::account (3), pull.account);
+	ASSERT_EQ (2, client1->pulls.size ());
+	ASSERT_EQ (1, client2->pulls.size ());
+	ASSERT_EQ (nano::account (4), client2->pulls.front ().account);
+	// Unserved pulls go back to the front of the shared queue
+	attempt->return_pulls (client1->pulls);
+	ASSERT_TRUE (client1->pulls.empty ());
+	ASSERT_EQ (2, attempt->pulls.size ());
+	ASSERT_EQ (nano::account (1), attempt->pulls.front ().account);
+	ASSERT_EQ (2, attempt->pulling);
+	client2->pulls.clear ();
+	ASSERT_FALSE (attempt->steal_pull (client1, pull));
+}
+
+TEST (bootstrap_peer_scores, ranking)
+{
+	nano::bootstrap_peer_scores scores;
+	nano::tcp_endpoint fast (boost::asio::ip::address_v6::loopback (), 10000);
+	nano::tcp_endpoint slow (boost::asio::ip::address_v6::loopback (), 10001);
+	nano::tcp_endpoint failing (boost::asio::ip::address_v6::loopback (), 10002);
+	nano::tcp_endpoint unknown (boost::asio::ip::address_v6::loopback (), 10003);
+	scores.connected (fast, std::chrono::milliseconds (10));
+	scores.pulled (fast, 4000, 0, std::chrono::seconds (1), true);
+	scores.pulled (slow, 1000, 1000, std::chrono::seconds (1), true);
+	for (auto i (0); i < 8; ++i)
+	{
+		scores.connect_failed (failing);
+	}
+	ASSERT_EQ (3, scores.size ());
+	auto list (scores.list ());
+	ASSERT_EQ (fast, list[0].endpoint);
+	ASSERT_EQ (10, list[0].latency.count ());
+	ASSERT_EQ (0.5, list[1].validity ());
+	ASSERT_EQ (1.0, list[2].failure_rate ());
+	// Mean score is (4000 + 500) / 2, the slow peer is clamped to half the batch
+	ASSERT_NEAR (4000.0 / 2250.0, scores.relative_score (fast), 1e-9);
+	ASSERT_EQ (0.5, scores.relative_score (slow));
+	ASSERT_EQ (1.0, scores.relative_score (unknown));
+	ASSERT_TRUE (scores.usable (fast));
+	ASSERT_FALSE (scores.usable (failing));
+	ASSERT_TRUE (scores.usable (unknown));
+}
+
+TEST (lazy_block_filter, bounded)
+{
+	nano::lazy_block_filter filter (1024);
+	std::vector<nano::block_hash> hashes;
+	for (auto i (0); i < 64; ++i)
+	{
+		nano::block_hash hash;
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+		hashes.push_back (hash);
+		filter.insert (hash);
+	}
+	for (auto & hash : hashes)
+	{
+		ASSERT_TRUE (filter.contains (hash));
+	}
+	ASSERT_EQ (64, filter.size ());
+	ASSERT_FALSE (filter.contains (nano::block_hash (1)));
+	// Past the ceiling older hashes are forgotten instead of growing
+	for (auto i (0); i < 1000; ++i)
+	{
+		nano::block_hash hash;
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+		filter.insert (hash);
+	}
+	ASSERT_EQ (1024, filter.memory ());
+	ASSERT_LE (filter.size (), 1024 / sizeof (uint64_t));
+	ASSERT_GT (filter.evicted, 0);
+	filter.clear ();
+	ASSERT_EQ (0, filter.size ());
+	ASSERT_EQ (0, filter.memory ());
+	ASSERT_FALSE (filter.contains (hashes[0]));
+}
+
+TEST (lazy_expiring_map, bounded)
+{
+	using map_type = nano::lazy_expiring_map<nano::uint128_t>;
+	map_type map (2 * map_type::entry_memory, std::chrono::hours (1));
+	map.insert (nano::block_hash (1), 10);
+	map.insert (nano::block_hash (2), 20);
+	// Existing entries are not replaced
+	map.insert (nano::block_hash (2), 30);
+	ASSERT_EQ (20, *map.find (nano::block_hash (2)));
+	map.insert (nano::block_hash (3), 30);
+	ASSERT_EQ (2, map.size ());
+	ASSERT_EQ (nullptr, map.find (nano::block_hash (1)));
+	ASSERT_EQ (1, map.evicted);
+	map.erase (nano::block_hash (2));
+	ASSERT_EQ (1, map.size ());
+	map_type expiring (1024, std::chrono::milliseconds (0));
+	expiring.insert (nano::block_hash (1), 10);
+	std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	expiring.insert (nano::block_hash (2), 20);
+	ASSERT_EQ (nullptr, expiring.find (nano::block_hash (1)));
+	ASSERT_NE (nullptr, expiring.find (nano::block_hash (2)));
+}
+
 TEST (frontier_req_response, DISABLED_destruction)
 {
 	{
@@ -1058,6 +1464,46 @@ TEST (frontier_req, time_cutoff)
 	ASSERT_TRUE (request2->frontier.is_zero ());
 }
 
+TEST (frontier_req, read_window)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key1 ("ED5AE0A6505B14B67435C29FD9FEEBC26F597D147BC92F6D795FFAD7AFD3D967");
+	nano::state_block send1 (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	node1.work_generate_blocking (send1);
+	ASSERT_EQ (nano::process_result::progress, node1.process (send1).code);
+	nano::state_block receive1 (key1.pub, 0, nano::test_genesis_key.pub, nano::Gxrb_ratio, send1.hash (), key1.prv, key1.pub, 0);
+	node1.work_generate_blocking (receive1);
+	ASSERT_EQ (nano::process_result::progress, node1.process (receive1).code);
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, system.nodes[0]));
+	std::unique_ptr<nano::frontier_req> req (new nano::frontier_req);
+	req->start.clear ();
+	req->age = std::numeric_limits<decltype (req->age)>::max ();
+	req->count = std::numeric_limits<decltype (req->count)>::max ();
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::frontier_req_server> (connection, std::move (req)));
+	// Both frontiers and the terminating zero pair are serialized in a single window
+	request->read_window ();
+	ASSERT_TRUE (request->next_last);
+	ASSERT_EQ (3 * nano::frontier_req_client::size_frontier, request->next_buffer->size ());
+	nano::bufferstream stream (request->next_buffer->data (), request->next_buffer->size ());
+	nano::account account;
+	nano::block_hash frontier;
+	ASSERT_FALSE (nano::try_read (stream, account));
+	ASSERT_FALSE (nano::try_read (stream, frontier));
+	ASSERT_EQ (nano::test_genesis_key.pub, account);
+	ASSERT_EQ (send1.hash (), frontier);
+	ASSERT_FALSE (nano::try_read (stream, account));
+	ASSERT_FALSE (nano::try_read (stream, frontier));
+	ASSERT_EQ (key1.pub, account);
+	ASSERT_EQ (receive1.hash (), frontier);
+	ASSERT_FALSE (nano::try_read (stream, account));
+	ASSERT_FALSE (nano::try_read (stream, frontier));
+	ASSERT_TRUE (account.is_zero ());
+	ASSERT_TRUE (frontier.is_zero ());
+}
+
 TEST (bulk, genesis)
 {
 	nano::system system (24000, 1);
@@ -1438,6 +1884,84 @@ TEST (bulk_pull_account, basics)
 	}
 }
 
+// The response is the frontier, the pending entries and a terminator of the entry size, which all fit the first window here
+TEST (bulk_pull_account, stream)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::keypair key1;
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	auto send1 (system.wallet (0)->send_action (nano::genesis_account, key1.pub, 100));
+	ASSERT_NE (nullptr, send1);
+	std::vector<std::pair<nano::bulk_pull_account_flags, size_t>> const flags_sizes{ { nano::bulk_pull_account_flags::pending_hash_and_amount, 48 }, { nano::bulk_pull_account_flags::pending_address_only, 32 }, { nano::bulk_pull_account_flags::pending_hash_amount_and_address, 80 } };
+	for (auto & flags_size : flags_sizes)
+	{
+		// An account with a pending entry and one without any, where the frontier and the terminator make up the whole response
+		std::vector<std::pair<nano::account, size_t>> const accounts_entries{ { key1.pub, 1 }, { nano::keypair ().pub, 0 } };
+		for (auto & account_entries : accounts_entries)
+		{
+			nano::bulk_pull_account req;
+			req.account = account_entries.first;
+			req.minimum_amount = 0;
+			req.flags = flags_size.first;
+			auto input (req.to_bytes ());
+			auto socket (std::make_shared<nano::socket> (system.nodes[0]));
+			auto expected_size (48 + (account_entries.second + 1) * flags_size.second);
+			auto output (std::make_shared<std::vector<uint8_t>> (expected_size));
+			std::atomic<bool> done (false);
+			socket->async_connect (node.bootstrap.endpoint (), [socket, input, output, expected_size, &done](boost::system::error_code const & ec) {
+				ASSERT_FALSE (ec);
+				socket->async_write (input, [socket, output, expected_size, &done](boost::system::error_code const & ec, size_t) {
+					ASSERT_FALSE (ec);
+					socket->async_read (output, expected_size, [output, expected_size, &done](boost::system::error_code const & ec, size_t size_a) {
+						ASSERT_FALSE (ec);
+						ASSERT_EQ (expected_size, size_a);
+						done = true;
+					});
+				});
+			});
+			system.deadline_set (5s);
+			while (!done)
+			{
+				ASSERT_NO_ERROR (system.poll ());
+			}
+			nano::bufferstream stream (output->data (), output->size ());
+			nano::block_hash frontier;
+			nano::amount balance;
+			ASSERT_FALSE (nano::try_read (stream, frontier.bytes));
+			ASSERT_FALSE (nano::try_read (stream, balance.bytes));
+			ASSERT_TRUE (frontier.is_zero ());
+			ASSERT_TRUE (balance.is_zero ());
+			if (account_entries.second != 0)
+			{
+				if (flags_size.first == nano::bulk_pull_account_flags::pending_address_only)
+				{
+					nano::account source;
+					ASSERT_FALSE (nano::try_read (stream, source.bytes));
+					ASSERT_EQ (nano::genesis_account, source);
+				}
+				else
+				{
+					nano::block_hash hash;
+					nano::amount amount;
+					ASSERT_FALSE (nano::try_read (stream, hash.bytes));
+					ASSERT_FALSE (nano::try_read (stream, amount.bytes));
+					ASSERT_EQ (send1->hash (), hash);
+					ASSERT_EQ (nano::amount (100), amount);
+					if (flags_size.first == nano::bulk_pull_account_flags::pending_hash_amount_and_address)
+					{
+						nano::account source;
+						ASSERT_FALSE (nano::try_read (stream, source.bytes));
+						ASSERT_EQ (nano::genesis_account, source);
+					}
+				}
+			}
+			// The terminator is all zeros
+			ASSERT_TRUE (std::all_of (output->end () - flags_size.second, output->end (), [](uint8_t byte_a) { return byte_a == 0; }));
+		}
+	}
+}
+
 TEST (bootstrap, tcp_node_id_handshake)
 {
 	nano::system system (24000, 1);
@@ -2400,3 +2924,191 @@ TEST (bandwidth_limiter, validate)
 		ASSERT_EQ (limiter_1536.get_rate (), full_confirm_ack); //should be 0 since nothing is small enough to pass through is tracked
 	}
 }
+
+TEST (bandwidth_limiter, traffic_classes)
+{
+	size_t const full_confirm_ack (488 + 8);
+	size_t const publish_state (216 + 8);
+	// Votes are capped well below the aggregate budget, blocks only by the aggregate
+	nano::outbound_bandwidth_limiter limiter (1024 * 1024, 1024 * 20);
+	ASSERT_FALSE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	ASSERT_FALSE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	// Burst capacity for votes is 1024 bytes, all spent
+	ASSERT_TRUE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	for (auto i (0); i < 10; ++i)
+	{
+		ASSERT_FALSE (limiter.should_drop (nano::bandwidth_limit_type::blocks, publish_state));
+	}
+	ASSERT_EQ (1, limiter.get_drops (nano::bandwidth_limit_type::votes));
+	ASSERT_EQ (0, limiter.get_drops (nano::bandwidth_limit_type::blocks));
+	ASSERT_EQ (0, limiter.get_drops (nano::bandwidth_limit_type::bootstrap));
+	ASSERT_EQ (nano::bandwidth_limit_type::votes, nano::outbound_bandwidth_limiter::type_of (nano::stat::detail::confirm_ack));
+	ASSERT_EQ (nano::bandwidth_limit_type::blocks, nano::outbound_bandwidth_limiter::type_of (nano::stat::detail::publish));
+	ASSERT_EQ (nano::bandwidth_limit_type::bootstrap, nano::outbound_bandwidth_limiter::type_of (nano::stat::detail::bulk_pull));
+	ASSERT_EQ (nano::bandwidth_limit_type::other, nano::outbound_bandwidth_limiter::type_of (nano::stat::detail::keepalive));
+}
+
+TEST (bandwidth_limiter, aggregate_refund)
+{
+	size_t const full_confirm_ack (488 + 8);
+	// Aggregate burst capacity is 1024 bytes, a vote budget larger than that never drops first
+	nano::outbound_bandwidth_limiter limiter (1024 * 20, 1024 * 1024);
+	ASSERT_FALSE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	ASSERT_FALSE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	ASSERT_TRUE (limiter.should_drop (nano::bandwidth_limit_type::blocks, full_confirm_ack));
+	ASSERT_TRUE (limiter.should_drop (nano::bandwidth_limit_type::votes, full_confirm_ack));
+	ASSERT_EQ (1, limiter.get_drops (nano::bandwidth_limit_type::votes));
+	ASSERT_EQ (1, limiter.get_drops (nano::bandwidth_limit_type::blocks));
+}
+
+TEST (bandwidth_limiter, concurrent)
+{
+	size_t const message_size (100);
+	// Burst capacity of 10 messages, refilled with a message every 5ms
+	nano::bandwidth_limiter limiter (20000);
+	std::atomic<unsigned> accepted{ 0 };
+	auto start (std::chrono::steady_clock::now ());
+	std::vector<std::thread> threads;
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.emplace_back ([&limiter, &accepted, message_size]() {
+			for (auto j (0); j < 50; ++j)
+			{
+				if (!limiter.should_drop (message_size))
+				{
+					++accepted;
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	auto refilled (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start).count () / 5 + 1);
+	ASSERT_LE (accepted, 10 + refilled);
+	ASSERT_GE (accepted, 10);
+	ASSERT_EQ (200 - accepted, limiter.get_drops ());
+}
+
+TEST (confirm_req_scheduler, window)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	size_t const hashes_max (nano::network::confirm_req_hashes_max);
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, nano::endpoint (boost::asio::ip::address_v6::loopback (), 24001), node.network_params.protocol.protocol_version));
+	std::vector<std::pair<nano::block_hash, nano::block_hash>> pairs;
+	for (size_t i (0); i < nano::confirm_req_scheduler::max_outstanding + 24; ++i)
+	{
+		pairs.emplace_back (nano::block_hash (i + 1), nano::block_hash (0));
+	}
+	std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> requests;
+	requests[channel] = pairs;
+	node.network.confirm_reqs.request (requests);
+	ASSERT_EQ (nano::confirm_req_scheduler::max_outstanding, node.network.confirm_reqs.outstanding_size ());
+	ASSERT_EQ (24, node.network.confirm_reqs.queued_size ());
+	// Outstanding and queued pairs are not requested again
+	node.network.confirm_reqs.request (requests);
+	ASSERT_EQ (nano::confirm_req_scheduler::max_outstanding, node.network.confirm_reqs.outstanding_size ());
+	ASSERT_EQ (24, node.network.confirm_reqs.queued_size ());
+	// A vote for the first pairs opens the window and updates the latency, a vote for a queued pair drops it
+	std::vector<nano::block_hash> hashes;
+	for (size_t i (0); i < hashes_max; ++i)
+	{
+		hashes.push_back (pairs[i].first);
+	}
+	hashes.push_back (pairs.back ().first);
+	nano::keypair key;
+	node.network.confirm_reqs.response (channel, std::make_shared<nano::vote> (key.pub, key.prv, 0, hashes));
+	// A pending flush may refill the window already
+	ASSERT_EQ (nano::confirm_req_scheduler::max_outstanding - hashes_max + 23, node.network.confirm_reqs.outstanding_size () + node.network.confirm_reqs.queued_size ());
+	ASSERT_LT (node.network.confirm_reqs.latency (channel->get_endpoint ()), nano::confirm_req_scheduler::default_latency);
+	node.network.confirm_reqs.flush ();
+	ASSERT_EQ (nano::confirm_req_scheduler::max_outstanding, node.network.confirm_reqs.outstanding_size ());
+	ASSERT_EQ (23 - hashes_max, node.network.confirm_reqs.queued_size ());
+}
+
+TEST (confirm_req_scheduler, full_batch)
+{
+	std::vector<nano::transport::transport_type> types{ nano::transport::transport_type::tcp, nano::transport::transport_type::udp };
+	for (auto & type : types)
+	{
+		nano::system system (24000, 2, type);
+		auto & node0 (*system.nodes[0]);
+		auto & node1 (*system.nodes[1]);
+		system.wallet (1)->insert_adhoc (nano::test_genesis_key.prv);
+		size_t hashes_max (nano::network::confirm_req_hashes_max);
+		if (type == nano::transport::transport_type::tcp)
+		{
+			hashes_max = nano::network::confirm_req_hashes_max_tcp;
+		}
+		nano::keypair key;
+		std::vector<std::pair<nano::block_hash, nano::block_hash>> pairs;
+		auto previous (node1.latest (nano::test_genesis_key.pub));
+		auto balance (nano::genesis_amount);
+		{
+			auto transaction (node1.store.tx_begin_write ());
+			for (size_t i (0); i < hashes_max; ++i)
+			{
+				balance -= 1;
+				nano::send_block send (previous, key.pub, balance, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous));
+				ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, send).code);
+				pairs.emplace_back (send.hash (), send.root ());
+				previous = send.hash ();
+			}
+		}
+		auto channel (node0.network.find_channel (node1.network.endpoint ()));
+		ASSERT_NE (nullptr, channel);
+		ASSERT_EQ (type, channel->get_type ());
+		std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> requests;
+		requests[channel] = pairs;
+		node0.network.confirm_reqs.request (requests);
+		ASSERT_EQ (hashes_max, node0.network.confirm_reqs.outstanding_size ());
+		ASSERT_EQ (0, node0.network.confirm_reqs.queued_size ());
+		// The batch was sent as one confirm_req and every pair in it is answered
+		auto outstanding (hashes_max);
+		system.deadline_set (10s);
+		while (outstanding != 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+			auto outstanding_l (node0.network.confirm_reqs.outstanding_size ());
+			ASSERT_LE (outstanding_l, outstanding);
+			outstanding = outstanding_l;
+		}
+		// No pair expired and was requested again
+		ASSERT_EQ (1, node1.stats.count (nano::stat::type::message, nano::stat::detail::confirm_req, nano::stat::dir::in));
+		ASSERT_NE (nano::confirm_req_scheduler::default_latency, node0.network.confirm_reqs.latency (channel->get_endpoint ()));
+	}
+}
+
+TEST (confirm_req_scheduler, latency_kept)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, nano::endpoint (boost::asio::ip::address_v6::loopback (), 24001), node.network_params.protocol.protocol_version));
+	std::vector<std::pair<nano::block_hash, nano::block_hash>> pairs;
+	std::vector<nano::block_hash> hashes;
+	for (size_t i (0); i < nano::network::confirm_req_hashes_max; ++i)
+	{
+		pairs.emplace_back (nano::block_hash (i + 1), nano::block_hash (0));
+		hashes.push_back (pairs.back ().first);
+	}
+	std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> requests;
+	requests[channel] = pairs;
+	node.network.confirm_reqs.request (requests);
+	ASSERT_EQ (pairs.size (), node.network.confirm_reqs.outstanding_size ());
+	// The representative answers everything
+	nano::keypair key;
+	node.network.confirm_reqs.response (channel, std::make_shared<nano::vote> (key.pub, key.prv, 0, hashes));
+	auto latency (node.network.confirm_reqs.latency (channel->get_endpoint ()));
+	ASSERT_LT (latency, nano::confirm_req_scheduler::default_latency);
+	node.network.confirm_reqs.flush ();
+	ASSERT_EQ (0, node.network.confirm_reqs.outstanding_size ());
+	ASSERT_EQ (0, node.network.confirm_reqs.queued_size ());
+	ASSERT_EQ (latency, node.network.confirm_reqs.latency (channel->get_endpoint ()));
+	// The next request round keeps the latency measured before the queues drained
+	requests[channel] = { { nano::block_hash (pairs.size () + 1), nano::block_hash (0) } };
+	node.network.confirm_reqs.request (requests);
+	ASSERT_EQ (1, node.network.confirm_reqs.outstanding_size ());
+	ASSERT_EQ (latency, node.network.confirm_reqs.latency (channel->get_endpoint ()));
+}
@@ -1954,6 +1954,39 @@ TEST (node, rep_list)
 	}
 }
 
+// Representatives are found by the vote observer while several vote processor threads apply votes and elections finish
+TEST (node, rep_crawler_vote_processor_threads)
+{
+	nano::system system;
+	nano::node_config node_config (24000, system.logging);
+	node_config.vote_processor_threads = 4;
+	auto & node0 (*system.add_node (node_config));
+	node_config.peering_port = 24001;
+	auto & node1 (*system.add_node (node_config));
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto previous (genesis.hash ());
+	auto balance (nano::genesis_amount);
+	for (auto i (0); i < 20; ++i)
+	{
+		balance -= nano::Gxrb_ratio;
+		auto send (std::make_shared<nano::send_block> (previous, key.pub, balance, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous)));
+		previous = send->hash ();
+		node0.process_active (send);
+		node1.process_active (send);
+	}
+	system.deadline_set (10s);
+	auto done (false);
+	while (!done)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+		auto transaction (node1.store.tx_begin_read ());
+		done = !node1.rep_crawler.representatives (1).empty () && node1.ledger.block_confirmed (transaction, previous);
+	}
+	ASSERT_EQ (nano::test_genesis_key.pub, node1.rep_crawler.representatives (1)[0].account);
+}
+
 TEST (node, rep_weight)
 {
 	nano::system system (24000, 1);
@@ -2286,6 +2319,35 @@ TEST (node, block_arrival_time)
 	ASSERT_EQ (nano::block_arrival::arrival_size_min * 2, node.block_arrival.arrival.size ());
 }
 
+TEST (node, block_arrival_trace)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::block_hash hash1 (1);
+	nano::block_hash hash2 (2);
+	node.block_arrival.add (hash1);
+	node.block_arrival.trace (hash1, nano::block_stage::processed);
+	// Only the first time a stage is reached counts
+	node.block_arrival.trace (hash1, nano::block_stage::processed);
+	// Blocks that did not arrive live are not traced
+	node.block_arrival.trace (hash2, nano::block_stage::processed);
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::latency_processed));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::latency_confirmed));
+	nano::block_arrival_info timings;
+	ASSERT_FALSE (node.block_arrival.timings (hash1, timings));
+	ASSERT_NE (std::chrono::steady_clock::time_point (), timings.stages[static_cast<size_t> (nano::block_stage::processed)]);
+	ASSERT_EQ (std::chrono::steady_clock::time_point (), timings.stages[static_cast<size_t> (nano::block_stage::confirmed)]);
+	ASSERT_TRUE (node.block_arrival.timings (hash2, timings));
+	nano::stat stats;
+	stats.add_latency (nano::stat::type::latency_cemented, std::chrono::milliseconds (5));
+	stats.add_latency (nano::stat::type::latency_cemented, std::chrono::milliseconds (500));
+	stats.add_latency (nano::stat::type::latency_cemented, std::chrono::minutes (2));
+	ASSERT_EQ (3, stats.count (nano::stat::type::latency_cemented));
+	ASSERT_EQ (1, stats.count (nano::stat::type::latency_cemented, nano::stat::detail::latency_10ms));
+	ASSERT_EQ (1, stats.count (nano::stat::type::latency_cemented, nano::stat::detail::latency_1s));
+	ASSERT_EQ (1, stats.count (nano::stat::type::latency_cemented, nano::stat::detail::latency_long));
+}
+
 TEST (node, confirm_quorum)
 {
 	nano::system system (24000, 1);
@@ -2341,11 +2403,17 @@ TEST (node, local_votes_cache)
 		node.network.process_message (message1, channel);
 		node.network.process_message (message2, channel);
 	}
+	// Requests for both blocks are answered by a single aggregated vote
+	system.deadline_set (5s);
+	while (node.votes_cache.find (send1->hash ()).empty () || node.votes_cache.find (send2->hash ()).empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
 	{
 		std::lock_guard<std::mutex> lock (node.store.get_cache_mutex ());
 		auto transaction (node.store.tx_begin_read ());
 		auto current_vote (node.store.vote_current (transaction, nano::test_genesis_key.pub));
-		ASSERT_EQ (current_vote->sequence, 2);
+		ASSERT_EQ (current_vote->sequence, 1);
 	}
 	// Max cache
 	{
@@ -2357,11 +2425,16 @@ TEST (node, local_votes_cache)
 	{
 		node.network.process_message (message3, channel);
 	}
+	system.deadline_set (5s);
+	while (node.votes_cache.find (send3->hash ()).empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
 	{
 		std::lock_guard<std::mutex> lock (node.store.get_cache_mutex ());
 		auto transaction (node.store.tx_begin_read ());
 		auto current_vote (node.store.vote_current (transaction, nano::test_genesis_key.pub));
-		ASSERT_EQ (current_vote->sequence, 3);
+		ASSERT_EQ (current_vote->sequence, 2);
 	}
 	ASSERT_TRUE (node.votes_cache.find (send1->hash ()).empty ());
 	ASSERT_FALSE (node.votes_cache.find (send2->hash ()).empty ());
@@ -2387,6 +2460,11 @@ TEST (node, local_votes_cache_generate_new_vote)
 	{
 		node.network.process_message (message1, channel);
 	}
+	system.deadline_set (5s);
+	while (node.votes_cache.find (send1->hash ()).empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
 	auto votes1 (node.votes_cache.find (send1->hash ()));
 	ASSERT_EQ (1, votes1.size ());
 	ASSERT_EQ (1, votes1[0]->blocks.size ());
@@ -2409,6 +2487,11 @@ TEST (node, local_votes_cache_generate_new_vote)
 	{
 		node.network.process_message (message2, channel);
 	}
+	system.deadline_set (5s);
+	while (node.votes_cache.find (send2->hash ()).empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
 	auto votes2 (node.votes_cache.find (send1->hash ()));
 	ASSERT_EQ (1, votes2.size ());
 	ASSERT_EQ (2, votes2[0]->blocks.size ());
@@ -2423,6 +2506,31 @@ TEST (node, local_votes_cache_generate_new_vote)
 	ASSERT_FALSE (node.votes_cache.find (send2->hash ()).empty ());
 }
 
+TEST (votes_cache, memory_bound)
+{
+	nano::stat stats;
+	nano::votes_cache cache (stats);
+	nano::keypair key1, key2;
+	// One vote covering two hashes is found under each of them
+	auto vote1 (std::make_shared<nano::vote> (key1.pub, key1.prv, 1, std::vector<nano::block_hash>{ 1, 2 }));
+	cache.add (vote1);
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (2 * nano::votes_cache::entry_size (1), cache.size_bytes ());
+	ASSERT_EQ (vote1, cache.find (1)[0]);
+	ASSERT_EQ (vote1, cache.find (2)[0]);
+	ASSERT_EQ (2, stats.count (nano::stat::type::vote, nano::stat::detail::vote_cache_hit));
+	// The test network budget holds two single vote entries, the oldest is evicted
+	auto vote2 (std::make_shared<nano::vote> (key2.pub, key2.prv, 1, std::vector<nano::block_hash>{ 3 }));
+	cache.add (vote2);
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (1, stats.count (nano::stat::type::vote, nano::stat::detail::vote_cache_evict));
+	ASSERT_TRUE (cache.find (1).empty ());
+	ASSERT_EQ (1, stats.count (nano::stat::type::vote, nano::stat::detail::vote_cache_miss));
+	ASSERT_FALSE (cache.find (3).empty ());
+	cache.remove (3);
+	ASSERT_EQ (nano::votes_cache::entry_size (1), cache.size_bytes ());
+}
+
 TEST (node, vote_republish)
 {
 	nano::system system (24000, 2);
@@ -2686,7 +2794,6 @@ TEST (node, fork_invalid_block_signature_vote_by_hash)
 	auto vote (std::make_shared<nano::vote> (nano::test_genesis_key.pub, nano::test_genesis_key.prv, 0, vote_blocks));
 	{
 		auto transaction (system.nodes[0]->store.tx_begin_read ());
-		std::unique_lock<std::mutex> lock (system.nodes[0]->active.mutex);
 		system.nodes[0]->vote_processor.vote_blocking (transaction, vote, std::make_shared<nano::transport::channel_udp> (system.nodes[0]->network.udp_channels, system.nodes[0]->network.endpoint (), system.nodes[0]->network_params.protocol.protocol_version));
 	}
 	while (system.nodes[0]->block (send1->hash ()))
@@ -2805,6 +2912,36 @@ TEST (node, block_processor_reject_rolled_back)
 	ASSERT_TRUE (node.active.empty ());
 }
 
+TEST (node, block_processor_dependency_order)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send1);
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send2);
+	auto open1 (std::make_shared<nano::state_block> (key1.pub, 0, key1.pub, nano::Gxrb_ratio, send1->hash (), key1.prv, key1.pub, 0));
+	node.work_generate_blocking (*open1);
+	{
+		// Queue everything in reverse order, as bulk_pull delivers it, before the processor can write
+		auto write_guard = node.write_database_queue.wait (nano::writer::confirmation_height);
+		node.block_processor.add (open1);
+		node.block_processor.add (send2);
+		node.block_processor.add (send1);
+	}
+	node.block_processor.flush ();
+	ASSERT_TRUE (node.ledger.block_exists (send1->hash ()));
+	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
+	ASSERT_TRUE (node.ledger.block_exists (open1->hash ()));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::block, nano::stat::detail::gap_previous));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::block, nano::stat::detail::gap_source));
+	ASSERT_LE (2, node.stats.count (nano::stat::type::block, nano::stat::detail::dependency_deferred));
+	auto transaction (node.store.tx_begin_read ());
+	ASSERT_EQ (0, node.store.unchecked_count (transaction));
+}
+
 TEST (node, block_processor_full)
 {
 	nano::system system;
@@ -2862,6 +2999,39 @@ TEST (node, block_processor_half_full)
 	ASSERT_FALSE (node.block_processor.full ());
 }
 
+TEST (node, block_processor_capacity)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.block_processor_full_size = 4;
+	auto & node = *system.add_node (nano::node_config (24000, system.logging), node_flags);
+	nano::genesis genesis;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send1);
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send2);
+	ASSERT_EQ (2, node.block_processor.capacity ());
+	std::atomic<bool> resumed (false);
+	{
+		// The write guard prevents block processor doing any writes
+		auto write_guard = node.write_database_queue.wait (nano::writer::confirmation_height);
+		node.block_processor.add (send1);
+		node.block_processor.add (send2);
+		ASSERT_EQ (0, node.block_processor.capacity ());
+		node.block_processor.wait_capacity ([&resumed]() {
+			resumed = true;
+		});
+		ASSERT_FALSE (resumed);
+	}
+	// Waiters resume once the queued blocks are written
+	system.deadline_set (5s);
+	while (!resumed)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_LT (0, node.block_processor.capacity ());
+}
+
 TEST (node, confirm_back)
 {
 	nano::system system (24000, 1);
@@ -2882,7 +3052,6 @@ TEST (node, confirm_back)
 	auto vote (std::make_shared<nano::vote> (nano::test_genesis_key.pub, nano::test_genesis_key.prv, 0, vote_blocks));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		std::unique_lock<std::mutex> lock (node.active.mutex);
 		node.vote_processor.vote_blocking (transaction, vote, std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
 	}
 	system.deadline_set (10s);
@@ -3144,6 +3313,46 @@ TEST (node, bidirectional_tcp)
 
 namespace nano
 {
+TEST (node, vote_aggregator)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	nano::genesis genesis;
+	auto channel1 (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	auto channel2 (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, nano::endpoint (boost::asio::ip::address_v6::loopback (), 24001), node.network_params.protocol.protocol_version));
+	// Both peers ask for the same hash, a single vote answers them
+	node.vote_aggregator.add (channel1, std::vector<nano::block_hash> (1, genesis.hash ()));
+	node.vote_aggregator.add (channel2, std::vector<nano::block_hash> (1, genesis.hash ()));
+	system.deadline_set (5s);
+	while (node.votes_cache.find (genesis.hash ()).empty ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_generated));
+	ASSERT_EQ (0, node.vote_aggregator.size ());
+	// Later requests are answered from the cache
+	ASSERT_TRUE (node.network.send_votes_cache (channel1, genesis.hash ()));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_cached));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_generated));
+}
+
+TEST (node, vote_aggregator_overflow)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	// Hashes beyond the queue bound are dropped
+	std::vector<nano::block_hash> hashes;
+	for (size_t i (0); i < nano::vote_aggregator::max_queue + 10; ++i)
+	{
+		hashes.push_back (nano::block_hash (i + 1));
+	}
+	node.vote_aggregator.add (channel, hashes);
+	ASSERT_EQ (10, node.stats.count (nano::stat::type::drop, nano::stat::detail::confirm_req, nano::stat::dir::in));
+	ASSERT_GE (nano::vote_aggregator::max_queue, node.vote_aggregator.size ());
+}
+
 TEST (confirmation_height, prioritize_frontiers)
 {
 	nano::system system;
@@ -3282,6 +3491,51 @@ TEST (confirmation_height, prioritize_frontiers)
 		ASSERT_NE (node->active.roots.find (frontier), node->active.roots.end ());
 	}
 }
+
+TEST (confirmation_height, prioritize_frontiers_incremental)
+{
+	nano::system system;
+	nano::node_config node_config (24001, system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto node = system.add_node (node_config);
+	nano::keypair key1;
+	nano::block_hash latest1 (node->latest (nano::test_genesis_key.pub));
+	nano::send_block send1 (latest1, key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (latest1));
+	nano::send_block send2 (send1.hash (), key1.pub, nano::genesis_amount - 200, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1.hash ()));
+	nano::open_block open1 (send1.hash (), nano::genesis_account, key1.pub, key1.prv, key1.pub, system.work.generate (key1.pub));
+	nano::send_block send3 (send2.hash (), key1.pub, nano::genesis_amount - 300, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send2.hash ()));
+	{
+		auto transaction = node->store.tx_begin_write ();
+		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send1).code);
+		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send2).code);
+		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, open1).code);
+	}
+	auto uncemented = [&node](nano::account const & account_a) {
+		std::lock_guard<std::mutex> guard (node->active.mutex);
+		auto existing (node->active.priority_cementable_frontiers.find (account_a));
+		return existing != node->active.priority_cementable_frontiers.end () ? existing->blocks_uncemented : 0;
+	};
+	// A full ledger pass populates the index
+	{
+		auto transaction (node->store.tx_begin_read ());
+		node->active.prioritize_frontiers_for_confirmation (transaction, std::chrono::seconds (1), std::chrono::seconds (1));
+	}
+	ASSERT_TRUE (node->active.cementable_frontiers_complete);
+	ASSERT_EQ (2, uncemented (nano::test_genesis_key.pub));
+	ASSERT_EQ (1, uncemented (key1.pub));
+	// From then on it follows processed and cemented blocks without rescanning the ledger
+	{
+		auto transaction = node->store.tx_begin_write ();
+		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send3).code);
+		node->active.add_uncemented (transaction, nano::test_genesis_key.pub);
+	}
+	ASSERT_EQ (3, uncemented (nano::test_genesis_key.pub));
+	node->active.remove_uncemented (nano::test_genesis_key.pub, 2);
+	node->active.remove_uncemented (key1.pub, 1);
+	ASSERT_EQ (1, uncemented (nano::test_genesis_key.pub));
+	ASSERT_EQ (1, node->active.priority_cementable_frontiers_size ());
+	ASSERT_TRUE (node->active.cementable_frontiers_complete);
+}
 }
 
 TEST (confirmation_height, frontiers_confirmation_mode)
@@ -143,12 +143,18 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.rpc.child_process.rpc_path, defaults.rpc.child_process.rpc_path);
 
 	ASSERT_EQ (conf.node.active_elections_size, defaults.node.active_elections_size);
+	ASSERT_EQ (conf.node.active_elections_queue_size, defaults.node.active_elections_queue_size);
 	ASSERT_EQ (conf.node.allow_local_peers, defaults.node.allow_local_peers);
 	ASSERT_EQ (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_EQ (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
+	ASSERT_EQ (conf.node.bandwidth_limit_votes, defaults.node.bandwidth_limit_votes);
+	ASSERT_EQ (conf.node.bandwidth_limit_blocks, defaults.node.bandwidth_limit_blocks);
+	ASSERT_EQ (conf.node.bandwidth_limit_bootstrap, defaults.node.bandwidth_limit_bootstrap);
 	ASSERT_EQ (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_EQ (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_EQ (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
+	ASSERT_EQ (conf.node.bootstrap_serving_window, defaults.node.bootstrap_serving_window);
+	ASSERT_EQ (conf.node.bootstrap_lazy_max_memory, defaults.node.bootstrap_lazy_max_memory);
 	ASSERT_EQ (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_EQ (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
 	ASSERT_EQ (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
@@ -176,6 +182,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_EQ (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
 	ASSERT_EQ (conf.node.vote_minimum, defaults.node.vote_minimum);
+	ASSERT_EQ (conf.node.vote_processor_threads, defaults.node.vote_processor_threads);
 	ASSERT_EQ (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_EQ (conf.node.work_threads, defaults.node.work_threads);
 
@@ -363,12 +370,18 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ss << R"toml(
 	[node]
 	active_elections_size = 999
+	active_elections_queue_size = 999
 	allow_local_peers = false
 	backup_before_upgrade = true
 	bandwidth_limit = 999
+	bandwidth_limit_votes = 999
+	bandwidth_limit_blocks = 999
+	bandwidth_limit_bootstrap = 999
 	block_processor_batch_max_time = 999
 	bootstrap_connections = 999
 	bootstrap_connections_max = 999
+	bootstrap_serving_window = 999
+	bootstrap_lazy_max_memory = 999
 	bootstrap_fraction_numerator = 999
 	conf_height_processor_batch_min_time = 999
 	confirmation_history_size = 999
@@ -394,6 +407,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	vote_generator_delay = 999
 	vote_generator_threshold = 9
 	vote_minimum = "999"
+	vote_processor_threads = 999
 	work_peers = ["test.org:999"]
 	work_threads = 999
 	work_watcher_period = 999
@@ -499,12 +513,18 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.rpc.child_process.rpc_path, defaults.rpc.child_process.rpc_path);
 
 	ASSERT_NE (conf.node.active_elections_size, defaults.node.active_elections_size);
+	ASSERT_NE (conf.node.active_elections_queue_size, defaults.node.active_elections_queue_size);
 	ASSERT_NE (conf.node.allow_local_peers, defaults.node.allow_local_peers);
 	ASSERT_NE (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_NE (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
+	ASSERT_NE (conf.node.bandwidth_limit_votes, defaults.node.bandwidth_limit_votes);
+	ASSERT_NE (conf.node.bandwidth_limit_blocks, defaults.node.bandwidth_limit_blocks);
+	ASSERT_NE (conf.node.bandwidth_limit_bootstrap, defaults.node.bandwidth_limit_bootstrap);
 	ASSERT_NE (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_NE (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_NE (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
+	ASSERT_NE (conf.node.bootstrap_serving_window, defaults.node.bootstrap_serving_window);
+	ASSERT_NE (conf.node.bootstrap_lazy_max_memory, defaults.node.bootstrap_lazy_max_memory);
 	ASSERT_NE (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_NE (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
 	ASSERT_NE (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
@@ -533,6 +553,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_NE (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
 	ASSERT_NE (conf.node.vote_minimum, defaults.node.vote_minimum);
+	ASSERT_NE (conf.node.vote_processor_threads, defaults.node.vote_processor_threads);
 	ASSERT_NE (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_NE (conf.node.work_threads, defaults.node.work_threads);
 
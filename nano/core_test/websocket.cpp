@@ -545,6 +545,82 @@ TEST (websocket, confirmation_options)
 	node1->stop ();
 }
 
+/** Tests that only subscribers asking for latency get it when several subscribers share a confirmation */
+TEST (websocket, confirmation_latency)
+{
+	nano::system system (24000, 1);
+	nano::node_config config;
+	nano::node_flags node_flags;
+	config.websocket_config.enabled = true;
+	config.websocket_config.port = 24078;
+
+	auto node1 (std::make_shared<nano::node> (system.io_ctx, nano::unique_path (), system.alarm, config, system.work, node_flags));
+	nano::uint256_union wallet;
+	nano::random_pool::generate_block (wallet.bytes.data (), wallet.bytes.size ());
+	node1->wallets.create (wallet);
+	node1->start ();
+	system.nodes.push_back (node1);
+
+	auto subscriber = [](std::string const & message_a, std::atomic<bool> & finished_a, bool latency_a) {
+		auto response = websocket_test_call ("::1", "24078", message_a, true, true);
+
+		ASSERT_TRUE (response);
+		boost::property_tree::ptree event;
+		std::stringstream stream;
+		stream << response.get ();
+		boost::property_tree::read_json (stream, event);
+		ASSERT_EQ (event.get<std::string> ("topic"), "confirmation");
+		auto latency (event.get_child_optional ("message.latency"));
+		ASSERT_EQ (latency_a, !!latency);
+		if (latency_a)
+		{
+			ASSERT_TRUE (latency->get_optional<uint64_t> ("confirmed"));
+		}
+		finished_a = true;
+	};
+
+	// Subscribe one client at a time, the acknowledgement flag is shared
+	ack_ready = false;
+	std::atomic<bool> client_thread_finished{ false };
+	std::thread client_thread ([&subscriber, &client_thread_finished]() {
+		subscriber (R"json({"action": "subscribe", "topic": "confirmation", "ack": "true", "options": {"include_latency": "true"}})json", client_thread_finished, true);
+	});
+	system.deadline_set (5s);
+	while (!ack_ready)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ack_ready = false;
+
+	std::atomic<bool> client_thread_2_finished{ false };
+	std::thread client_thread_2 ([&subscriber, &client_thread_2_finished]() {
+		subscriber (R"json({"action": "subscribe", "topic": "confirmation", "ack": "true"})json", client_thread_2_finished, false);
+	});
+	system.deadline_set (5s);
+	while (!ack_ready)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ack_ready = false;
+
+	// Quick-confirm a block, both subscribers receive the same confirmation
+	system.wallet (1)->insert_adhoc (nano::test_genesis_key.prv);
+	nano::keypair key;
+	nano::block_hash previous (node1->latest (nano::test_genesis_key.pub));
+	auto send (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - node1->config.online_weight_minimum.number () - 1, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous)));
+	node1->process_active (send);
+
+	system.deadline_set (5s);
+	while (!client_thread_finished || !client_thread_2_finished)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+
+	client_thread.join ();
+	client_thread_2.join ();
+	node1->stop ();
+}
+
 /** Subscribes to votes, sends a block and awaits websocket notification of a vote arrival */
 TEST (websocket, vote)
 {
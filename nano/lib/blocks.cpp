@@ -18,10 +18,29 @@ bool blocks_equal (T const & first, nano::block const & second)
 }
 
 template <typename block>
-std::shared_ptr<block> deserialize_block (nano::stream & stream_a)
+std::shared_ptr<nano::block> deserialize_block (nano::stream & stream_a, nano::block_uniquer * uniquer_a)
 {
+	std::shared_ptr<nano::block> result;
 	auto error (false);
-	auto result = nano::make_shared<block> (error, stream_a);
+	if (uniquer_a == nullptr)
+	{
+		result = nano::make_shared<block> (error, stream_a);
+	}
+	else
+	{
+		// Blocks are mostly received several times from different peers, so decode on the stack and only
+		// allocate a shared block when the uniquer doesn't have a live copy already
+		block block_l (error, stream_a);
+		if (!error)
+		{
+			auto full_hash (block_l.full_hash ());
+			result = uniquer_a->find (full_hash);
+			if (result == nullptr)
+			{
+				result = uniquer_a->unique (full_hash, nano::make_shared<block> (block_l));
+			}
+		}
+	}
 	if (error)
 	{
 		result = nullptr;
@@ -91,7 +110,8 @@ nano::block_hash nano::block::full_hash () const
 	nano::block_hash result;
 	blake2b_state state;
 	blake2b_init (&state, sizeof (result.bytes));
-	blake2b_update (&state, hash ().bytes.data (), sizeof (hash ()));
+	auto hash_l (hash ());
+	blake2b_update (&state, hash_l.bytes.data (), sizeof (hash_l));
 	auto signature (block_signature ());
 	blake2b_update (&state, signature.bytes.data (), sizeof (signature));
 	auto work (block_work ());
@@ -1278,37 +1298,33 @@ std::shared_ptr<nano::block> nano::deserialize_block (nano::stream & stream_a, n
 	{
 		case nano::block_type::receive:
 		{
-			result = ::deserialize_block<nano::receive_block> (stream_a);
+			result = ::deserialize_block<nano::receive_block> (stream_a, uniquer_a);
 			break;
 		}
 		case nano::block_type::send:
 		{
-			result = ::deserialize_block<nano::send_block> (stream_a);
+			result = ::deserialize_block<nano::send_block> (stream_a, uniquer_a);
 			break;
 		}
 		case nano::block_type::open:
 		{
-			result = ::deserialize_block<nano::open_block> (stream_a);
+			result = ::deserialize_block<nano::open_block> (stream_a, uniquer_a);
 			break;
 		}
 		case nano::block_type::change:
 		{
-			result = ::deserialize_block<nano::change_block> (stream_a);
+			result = ::deserialize_block<nano::change_block> (stream_a, uniquer_a);
 			break;
 		}
 		case nano::block_type::state:
 		{
-			result = ::deserialize_block<nano::state_block> (stream_a);
+			result = ::deserialize_block<nano::state_block> (stream_a, uniquer_a);
 			break;
 		}
 		default:
 			assert (false);
 			break;
 	}
-	if (uniquer_a != nullptr)
-	{
-		result = uniquer_a->unique (result);
-	}
 	return result;
 }
 
@@ -1566,48 +1582,37 @@ std::shared_ptr<nano::block> nano::block_uniquer::unique (std::shared_ptr<nano::
 	auto result (block_a);
 	if (result != nullptr)
 	{
-		nano::uint256_union key (block_a->full_hash ());
-		std::lock_guard<std::mutex> lock (mutex);
-		auto & existing (blocks[key]);
-		if (auto block_l = existing.lock ())
-		{
-			result = block_l;
-		}
-		else
-		{
-			existing = block_a;
-		}
-		release_assert (std::numeric_limits<CryptoPP::word32>::max () > blocks.size ());
-		for (auto i (0); i < cleanup_count && !blocks.empty (); ++i)
-		{
-			auto random_offset (nano::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (blocks.size () - 1)));
-			auto existing (std::next (blocks.begin (), random_offset));
-			if (existing == blocks.end ())
-			{
-				existing = blocks.begin ();
-			}
-			if (existing != blocks.end ())
-			{
-				if (auto block_l = existing->second.lock ())
-				{
-					// Still live
-				}
-				else
-				{
-					blocks.erase (existing);
-				}
-			}
-		}
+		result = unique (block_a->full_hash (), block_a);
 	}
 	return result;
 }
 
+std::shared_ptr<nano::block> nano::block_uniquer::find (nano::uint256_union const & full_hash_a)
+{
+	return blocks.find (full_hash_a);
+}
+
+std::shared_ptr<nano::block> nano::block_uniquer::unique (nano::uint256_union const & key, std::shared_ptr<nano::block> block_a)
+{
+	assert (block_a != nullptr);
+	return blocks.unique (key, block_a);
+}
+
 size_t nano::block_uniquer::size ()
 {
-	std::lock_guard<std::mutex> lock (mutex);
 	return blocks.size ();
 }
 
+uint64_t nano::block_uniquer::hits () const
+{
+	return blocks.hits ();
+}
+
+uint64_t nano::block_uniquer::misses () const
+{
+	return blocks.misses ();
+}
+
 namespace nano
 {
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_uniquer & block_uniquer, const std::string & name)
@@ -346,12 +346,16 @@ public:
 	using value_type = std::pair<const nano::uint256_union, std::weak_ptr<nano::block>>;
 
 	std::shared_ptr<nano::block> unique (std::shared_ptr<nano::block>);
+	/** Same as unique (block) with the full hash of the block already computed */
+	std::shared_ptr<nano::block> unique (nano::uint256_union const &, std::shared_ptr<nano::block>);
+	/** Returns the live block with this full hash, or nullptr if there is none */
+	std::shared_ptr<nano::block> find (nano::uint256_union const &);
 	size_t size ();
+	uint64_t hits () const;
+	uint64_t misses () const;
 
 private:
-	std::mutex mutex;
-	std::unordered_map<std::remove_const_t<value_type::first_type>, value_type::second_type> blocks;
-	static unsigned constexpr cleanup_count = 2;
+	nano::sharded_uniquer<nano::uint256_union, nano::block> blocks;
 };
 
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_uniquer & block_uniquer, const std::string & name);
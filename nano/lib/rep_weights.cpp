@@ -27,8 +27,14 @@ std::unordered_map<nano::account, nano::uint128_t> nano::rep_weights::get_rep_am
 	return rep_amounts;
 }
 
+uint64_t nano::rep_weights::generation ()
+{
+	return generation_counter.load ();
+}
+
 void nano::rep_weights::put (nano::account const & account_a, nano::uint128_union const & representation_a)
 {
+	++generation_counter;
 	auto it = rep_amounts.find (account_a);
 	auto amount = representation_a.number ();
 	if (it != rep_amounts.end ())
@@ -3,6 +3,7 @@
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -19,10 +20,13 @@ public:
 	nano::uint128_t representation_get (nano::account const & account_a);
 	void representation_put (nano::account const & account_a, nano::uint128_union const & representation_a);
 	std::unordered_map<nano::account, nano::uint128_t> get_rep_amounts ();
+	/** Changes every time a representative's weight is updated */
+	uint64_t generation ();
 
 private:
 	std::mutex mutex;
 	std::unordered_map<nano::account, nano::uint128_t> rep_amounts;
+	std::atomic<uint64_t> generation_counter{ 0 };
 	void put (nano::account const & account_a, nano::uint128_union const & representation_a);
 	nano::uint128_t get (nano::account const & account_a);
 
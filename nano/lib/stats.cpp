@@ -302,6 +302,32 @@ void nano::stat::log_samples_impl (stat_log_sink & sink)
 	sink.finalize ();
 }
 
+void nano::stat::add_latency (stat::type type, std::chrono::milliseconds duration)
+{
+	auto bucket (stat::detail::latency_long);
+	if (duration < std::chrono::milliseconds (10))
+	{
+		bucket = stat::detail::latency_10ms;
+	}
+	else if (duration < std::chrono::milliseconds (100))
+	{
+		bucket = stat::detail::latency_100ms;
+	}
+	else if (duration < std::chrono::seconds (1))
+	{
+		bucket = stat::detail::latency_1s;
+	}
+	else if (duration < std::chrono::seconds (10))
+	{
+		bucket = stat::detail::latency_10s;
+	}
+	else if (duration < std::chrono::seconds (60))
+	{
+		bucket = stat::detail::latency_60s;
+	}
+	inc (type, bucket);
+}
+
 void nano::stat::update (uint32_t key_a, uint64_t value)
 {
 	static file_writer log_count (config.log_counters_filename);
@@ -435,6 +461,28 @@ std::string nano::stat::type_to_string (uint32_t key)
 			break;
 		case nano::stat::type::drop:
 			res = "drop";
+			break;
+		case nano::stat::type::duplicate:
+			res = "duplicate";
+			break;
+		case nano::stat::type::election:
+			res = "election";
+			break;
+		case nano::stat::type::latency_processed:
+			res = "latency_processed";
+			break;
+		case nano::stat::type::latency_election_started:
+			res = "latency_election_started";
+			break;
+		case nano::stat::type::latency_confirmed:
+			res = "latency_confirmed";
+			break;
+		case nano::stat::type::latency_cemented:
+			res = "latency_cemented";
+			break;
+		case nano::stat::type::latency_dispatched:
+			res = "latency_dispatched";
+			break;
 	}
 	return res;
 }
@@ -472,6 +520,12 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::bulk_pull_request_failure:
 			res = "bulk_pull_request_failure";
 			break;
+		case nano::stat::detail::bulk_pull_throttled:
+			res = "bulk_pull_throttled";
+			break;
+		case nano::stat::detail::bulk_pull_throttled_ms:
+			res = "bulk_pull_throttled_ms";
+			break;
 		case nano::stat::detail::bulk_push:
 			res = "bulk_push";
 			break;
@@ -502,6 +556,15 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::fork:
 			res = "fork";
 			break;
+		case nano::stat::detail::gap_previous:
+			res = "gap_previous";
+			break;
+		case nano::stat::detail::gap_source:
+			res = "gap_source";
+			break;
+		case nano::stat::detail::dependency_deferred:
+			res = "dependency_deferred";
+			break;
 		case nano::stat::detail::frontier_req:
 			res = "frontier_req";
 			break;
@@ -550,6 +613,48 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::epoch_block:
 			res = "epoch_block";
 			break;
+		case nano::stat::detail::election_admitted:
+			res = "election_admitted";
+			break;
+		case nano::stat::detail::election_queued:
+			res = "election_queued";
+			break;
+		case nano::stat::detail::election_evicted:
+			res = "election_evicted";
+			break;
+		case nano::stat::detail::election_dropped:
+			res = "election_dropped";
+			break;
+		case nano::stat::detail::election_queue_age_1s:
+			res = "election_queue_age_1s";
+			break;
+		case nano::stat::detail::election_queue_age_10s:
+			res = "election_queue_age_10s";
+			break;
+		case nano::stat::detail::election_queue_age_60s:
+			res = "election_queue_age_60s";
+			break;
+		case nano::stat::detail::election_queue_age_long:
+			res = "election_queue_age_long";
+			break;
+		case nano::stat::detail::latency_10ms:
+			res = "latency_10ms";
+			break;
+		case nano::stat::detail::latency_100ms:
+			res = "latency_100ms";
+			break;
+		case nano::stat::detail::latency_1s:
+			res = "latency_1s";
+			break;
+		case nano::stat::detail::latency_10s:
+			res = "latency_10s";
+			break;
+		case nano::stat::detail::latency_60s:
+			res = "latency_60s";
+			break;
+		case nano::stat::detail::latency_long:
+			res = "latency_long";
+			break;
 		case nano::stat::detail::vote_valid:
 			res = "vote_valid";
 			break;
@@ -562,6 +667,21 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::vote_overflow:
 			res = "vote_overflow";
 			break;
+		case nano::stat::detail::vote_generated:
+			res = "vote_generated";
+			break;
+		case nano::stat::detail::vote_cached:
+			res = "vote_cached";
+			break;
+		case nano::stat::detail::vote_cache_hit:
+			res = "vote_cache_hit";
+			break;
+		case nano::stat::detail::vote_cache_miss:
+			res = "vote_cache_miss";
+			break;
+		case nano::stat::detail::vote_cache_evict:
+			res = "vote_cache_evict";
+			break;
 		case nano::stat::detail::blocking:
 			res = "blocking";
 			break;
@@ -577,6 +697,12 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::tcp_write_drop:
 			res = "tcp_write_drop";
 			break;
+		case nano::stat::detail::tcp_read_batch:
+			res = "tcp_read_batch";
+			break;
+		case nano::stat::detail::tcp_read_message:
+			res = "tcp_read_message";
+			break;
 		case nano::stat::detail::unreachable_host:
 			res = "unreachable_host";
 			break;
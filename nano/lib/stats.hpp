@@ -236,7 +236,14 @@ public:
 		udp,
 		observer,
 		confirmation_height,
-		drop
+		drop,
+		duplicate,
+		election,
+		latency_processed,
+		latency_election_started,
+		latency_confirmed,
+		latency_cemented,
+		latency_dispatched
 	};
 
 	/** Optional detail type */
@@ -264,6 +271,11 @@ public:
 		epoch_block,
 		fork,
 
+		// block processor specific
+		gap_previous,
+		gap_source,
+		dependency_deferred,
+
 		// message specific
 		keepalive,
 		publish,
@@ -285,15 +297,40 @@ public:
 		bulk_pull_failed_account,
 		bulk_pull_receive_block_failure,
 		bulk_pull_request_failure,
+		bulk_pull_throttled,
+		bulk_pull_throttled_ms,
 		bulk_push,
 		frontier_req,
 		error_socket_close,
 
+		// election specific
+		election_admitted,
+		election_queued,
+		election_evicted,
+		election_dropped,
+		election_queue_age_1s,
+		election_queue_age_10s,
+		election_queue_age_60s,
+		election_queue_age_long,
+
+		// latency histogram buckets
+		latency_10ms,
+		latency_100ms,
+		latency_1s,
+		latency_10s,
+		latency_60s,
+		latency_long,
+
 		// vote specific
 		vote_valid,
 		vote_replay,
 		vote_invalid,
 		vote_overflow,
+		vote_generated,
+		vote_cached,
+		vote_cache_hit,
+		vote_cache_miss,
+		vote_cache_evict,
 
 		// udp
 		blocking,
@@ -313,6 +350,8 @@ public:
 		tcp_accept_success,
 		tcp_accept_failure,
 		tcp_write_drop,
+		tcp_read_batch,
+		tcp_read_message,
 
 		// ipc
 		invocations,
@@ -377,6 +416,9 @@ public:
 		add (type, detail, dir, 1);
 	}
 
+	/** Counts \p duration in the latency bucket detail it falls in, the details of \p type then form a histogram */
+	void add_latency (stat::type type, std::chrono::milliseconds duration);
+
 	/** Adds \p value to the given counter */
 	void add (stat::type type, stat::dir dir, uint64_t value)
 	{
@@ -6,9 +6,14 @@
 #include <boost/system/error_code.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace nano
@@ -218,6 +223,123 @@ inline std::unique_ptr<seq_con_info_component> collect_seq_con_info (observer_se
 	return composite;
 }
 
+/**
+ * Maps keys to weak references of live objects so equal objects can share one instance.
+ * Entries are split in shards by key hash so threads uniquing different keys rarely contend on the same mutex.
+ * Expired entries are swept a few hash buckets at a time on each insertion, in the inserted shard and in
+ * one other shard picked round robin so shards which stop receiving inserts are still reclaimed.
+ */
+template <typename Key, typename Value>
+class sharded_uniquer final
+{
+public:
+	using value_type = std::pair<const Key, std::weak_ptr<Value>>;
+
+	/** Returns the live object stored for \p key_a, or nullptr if there is none */
+	std::shared_ptr<Value> find (Key const & key_a)
+	{
+		std::shared_ptr<Value> result;
+		auto & shard (shards[shard_index (key_a)]);
+		{
+			std::lock_guard<std::mutex> lock (shard.mutex);
+			auto existing (shard.entries.find (key_a));
+			if (existing != shard.entries.end ())
+			{
+				result = existing->second.lock ();
+			}
+		}
+		if (result != nullptr)
+		{
+			hits_m.fetch_add (1, std::memory_order_relaxed);
+		}
+		return result;
+	}
+	/** Returns the live object stored for \p key_a if there is one, otherwise stores and returns \p value_a */
+	std::shared_ptr<Value> unique (Key const & key_a, std::shared_ptr<Value> const & value_a)
+	{
+		auto result (value_a);
+		{
+			auto & shard (shards[shard_index (key_a)]);
+			std::lock_guard<std::mutex> lock (shard.mutex);
+			auto & existing (shard.entries[key_a]);
+			if (auto existing_l = existing.lock ())
+			{
+				result = existing_l;
+				hits_m.fetch_add (1, std::memory_order_relaxed);
+			}
+			else
+			{
+				existing = value_a;
+				misses_m.fetch_add (1, std::memory_order_relaxed);
+			}
+			sweep (shard);
+		}
+		auto & other (shards[sweep_cursor.fetch_add (1, std::memory_order_relaxed) % shard_count]);
+		std::unique_lock<std::mutex> lock (other.mutex, std::try_to_lock);
+		if (lock.owns_lock ())
+		{
+			sweep (other);
+		}
+		return result;
+	}
+	size_t size ()
+	{
+		size_t result (0);
+		for (auto & shard : shards)
+		{
+			std::lock_guard<std::mutex> lock (shard.mutex);
+			result += shard.entries.size ();
+		}
+		return result;
+	}
+	/** Number of lookups which returned an already live object */
+	uint64_t hits () const
+	{
+		return hits_m.load (std::memory_order_relaxed);
+	}
+	/** Number of objects stored because no live equal object was known */
+	uint64_t misses () const
+	{
+		return misses_m.load (std::memory_order_relaxed);
+	}
+	static size_t constexpr shard_count = 16;
+
+private:
+	class shard final
+	{
+	public:
+		std::mutex mutex;
+		std::unordered_map<Key, std::weak_ptr<Value>> entries;
+		size_t cleanup_bucket{ 0 };
+	};
+	static size_t shard_index (Key const & key_a)
+	{
+		return std::hash<Key> () (key_a) % shard_count;
+	}
+	/** Removes at most one expired entry from each of the next cleanup_count buckets, shard mutex must be held */
+	void sweep (shard & shard_a)
+	{
+		auto & entries (shard_a.entries);
+		for (auto i (0); i < cleanup_count && !entries.empty (); ++i)
+		{
+			auto bucket (shard_a.cleanup_bucket++ % entries.bucket_count ());
+			auto expired (std::find_if (entries.cbegin (bucket), entries.cend (bucket), [](value_type const & entry_a) {
+				return entry_a.second.expired ();
+			}));
+			if (expired != entries.cend (bucket))
+			{
+				auto key (expired->first);
+				entries.erase (key);
+			}
+		}
+	}
+	static int constexpr cleanup_count = 2;
+	std::array<shard, shard_count> shards;
+	std::atomic<size_t> sweep_cursor{ 0 };
+	std::atomic<uint64_t> hits_m{ 0 };
+	std::atomic<uint64_t> misses_m{ 0 };
+};
+
 void remove_all_files_in_dir (boost::filesystem::path const & dir);
 void move_all_files_to_dir (boost::filesystem::path const & from, boost::filesystem::path const & to);
 }
@@ -1018,6 +1018,12 @@ int main (int argc, char * const * argv)
 			auto seconds (time / 1000000);
 			nano::remove_temporary_directories ();
 			std::cout << boost::str (boost::format ("%|1$ 12d| seconds \n%2% blocks per second") % seconds % (block_count / seconds)) << std::endl;
+			// Without dependency ordering every deferred block would have been a gap sent to unchecked
+			auto & stats (node2.node->stats);
+			auto gaps (stats.count (nano::stat::type::block, nano::stat::detail::gap_previous) + stats.count (nano::stat::type::block, nano::stat::detail::gap_source));
+			auto deferred (stats.count (nano::stat::type::block, nano::stat::detail::dependency_deferred));
+			auto blocks (std::max<uint64_t> (block_count, 1));
+			std::cout << boost::str (boost::format ("Gap rate %1$.2f%% unordered, %2$.2f%% dependency sorted (%3% blocks deferred)") % (100.0 * (gaps + deferred) / blocks) % (100.0 * gaps / blocks) % deferred) << std::endl;
 		}
 		else if (vm.count ("debug_peers"))
 		{
@@ -3,9 +3,12 @@
 
 #include <boost/pool/pool_alloc.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 size_t constexpr nano::active_transactions::max_broadcast_queue;
+size_t constexpr nano::active_transactions::max_requests_per_pass;
+size_t constexpr nano::active_transactions::max_adjust_difficulty_blocks;
 
 using namespace std::chrono;
 
@@ -66,9 +69,10 @@ void nano::active_transactions::confirm_frontiers (nano::transaction const & tra
 		prioritize_frontiers_for_confirmation (transaction_a, is_test_network ? std::chrono::milliseconds (50) : time_spent_prioritizing_ledger_accounts, time_spent_prioritizing_wallet_accounts);
 
 		size_t elections_count (0);
+		auto admission_full (false);
 		lk.lock ();
-		auto start_elections_for_prioritized_frontiers = [&transaction_a, &elections_count, max_elections, &lk, &representative, this](prioritize_num_uncemented & cementable_frontiers) {
-			while (!cementable_frontiers.empty () && !this->stopped && elections_count < max_elections)
+		auto start_elections_for_prioritized_frontiers = [&transaction_a, &elections_count, &admission_full, max_elections, &lk, &representative, this](prioritize_num_uncemented & cementable_frontiers) {
+			while (!cementable_frontiers.empty () && !this->stopped && elections_count < max_elections && !admission_full)
 			{
 				auto cementable_account_front_it = cementable_frontiers.get<1> ().begin ();
 				auto cementable_account = *cementable_account_front_it;
@@ -85,7 +89,8 @@ void nano::active_transactions::confirm_frontiers (nano::transaction const & tra
 					if (info.block_count > confirmation_height && !this->node.pending_confirmation_height.is_processing_block (info.head))
 					{
 						auto block (this->node.store.block_get (transaction_a, info.head));
-						if (!this->start (block))
+						auto result (this->start (block));
+						if (result == nano::election_start_result::started)
 						{
 							++elections_count;
 							// Calculate votes for local representatives
@@ -94,6 +99,11 @@ void nano::active_transactions::confirm_frontiers (nano::transaction const & tra
 								this->node.block_processor.generator.add (block->hash ());
 							}
 						}
+						else if (result == nano::election_start_result::queued)
+						{
+							// Active elections are full, leave the remaining frontiers in the index for a later pass
+							admission_full = true;
+						}
 					}
 				}
 				lk.lock ();
@@ -101,7 +111,12 @@ void nano::active_transactions::confirm_frontiers (nano::transaction const & tra
 		};
 		start_elections_for_prioritized_frontiers (priority_cementable_frontiers);
 		start_elections_for_prioritized_frontiers (priority_wallet_cementable_frontiers);
-		frontiers_fully_confirmed = (elections_count < max_elections);
+		frontiers_fully_confirmed = (elections_count < max_elections && !admission_full);
+		if (frontiers_fully_confirmed)
+		{
+			// Accounts taken from the index whose elections did not confirm are only found again by a ledger pass
+			cementable_frontiers_complete = false;
+		}
 		// 4 times slower check if all frontiers were confirmed
 		auto fully_confirmed_factor = frontiers_fully_confirmed ? 4 : 1;
 		// Calculate next check time
@@ -129,7 +144,24 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 	}
 	lock_a.lock ();
 	auto roots_size (roots.size ());
-	for (auto i (roots.get<1> ().begin ()), n (roots.get<1> ().end ()); i != n; ++i)
+	// Only elections due at this pass are visited, highest difficulty first as bundles are capped
+	wheel.advance (due);
+	std::vector<nano::conflict_info> due_elections;
+	while (!due.empty () && due_elections.size () < max_requests_per_pass)
+	{
+		auto existing (roots.find (due.front ()));
+		// Roots of erased elections are dropped here rather than searched for in the wheel
+		if (existing != roots.end () && existing->election->request_tick <= wheel.tick)
+		{
+			existing->election->request_tick = std::numeric_limits<uint64_t>::max ();
+			due_elections.push_back (*existing);
+		}
+		due.pop_front ();
+	}
+	std::sort (due_elections.begin (), due_elections.end (), [](nano::conflict_info const & lhs, nano::conflict_info const & rhs) {
+		return lhs.adjusted_difficulty > rhs.adjusted_difficulty;
+	});
+	for (auto i (due_elections.begin ()), n (due_elections.end ()); i != n; ++i)
 	{
 		auto root (i->root);
 		auto election_l (i->election);
@@ -150,6 +182,7 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 				// Log votes for very long unconfirmed elections
 				if (election_l->confirmation_request_count % 50 == 1)
 				{
+					std::lock_guard<std::mutex> election_lock (election_l->mutex);
 					auto tally_l (election_l->tally (transaction));
 					election_l->log_votes (tally_l);
 				}
@@ -216,15 +249,18 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 			// Add all rep endpoints that haven't already voted. We use a set since multiple
 			// reps may exist on an endpoint.
 			std::unordered_set<std::shared_ptr<nano::transport::channel>> channels;
-			for (auto & rep : reps)
 			{
-				if (election_l->last_votes.find (rep.account) == election_l->last_votes.end ())
+				std::lock_guard<std::mutex> election_lock (election_l->mutex);
+				for (auto & rep : reps)
 				{
-					channels.insert (rep.channel);
-
-					if (node.config.logging.vote_logging ())
+					if (election_l->last_votes.find (rep.account) == election_l->last_votes.end ())
 					{
-						node.logger.try_log ("Representative did not respond to confirm_req, retrying: ", rep.account.to_account ());
+						channels.insert (rep.channel);
+
+						if (node.config.logging.vote_logging ())
+						{
+							node.logger.try_log ("Representative did not respond to confirm_req, retrying: ", rep.account.to_account ());
+						}
 					}
 				}
 			}
@@ -280,6 +316,15 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 			}
 		}
 		++election_l->confirmation_request_count;
+		if (election_l->confirmation_request_count == high_confirmation_request_count + 1 && !election_l->confirmed && !election_l->stopped)
+		{
+			++long_unconfirmed_size;
+		}
+		if (inactive.find (root) == inactive.end ())
+		{
+			election_l->request_tick = wheel.tick + request_delay (election_l->confirmation_request_count);
+			wheel.schedule (root, election_l->request_tick - wheel.tick);
+		}
 	}
 	lock_a.unlock ();
 	// Rebroadcast unconfirmed blocks
@@ -290,7 +335,7 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 	// Batch confirmation request
 	if (!requests_bundle.empty ())
 	{
-		node.network.broadcast_confirm_req_batch (requests_bundle, 50);
+		node.network.confirm_reqs.request (requests_bundle);
 	}
 	//confirm_req broadcast
 	if (!confirm_req_bundle.empty ())
@@ -309,13 +354,20 @@ void nano::active_transactions::request_confirm (std::unique_lock<std::mutex> &
 			roots.erase (root_it);
 		}
 	}
-	long_unconfirmed_size = unconfirmed_count;
+	// Slots freed by this pass go to waiting candidates
+	admit ();
 	if (unconfirmed_count > 0)
 	{
 		node.logger.try_log (boost::str (boost::format ("%1% blocks have been unconfirmed averaging %2% confirmation requests") % unconfirmed_count % (unconfirmed_request_count / unconfirmed_count)));
 	}
 }
 
+uint64_t nano::active_transactions::request_delay (unsigned request_count_a) const
+{
+	// Long unconfirmed elections back off to a request every 16 passes
+	return request_count_a <= high_confirmation_request_count ? 1 : uint64_t (1) << std::min (request_count_a - high_confirmation_request_count, 4U);
+}
+
 void nano::active_transactions::request_loop ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
@@ -344,7 +396,7 @@ void nano::active_transactions::request_loop ()
 	}
 }
 
-void nano::active_transactions::prioritize_account_for_confirmation (nano::active_transactions::prioritize_num_uncemented & cementable_frontiers_a, size_t & cementable_frontiers_size_a, nano::account const & account_a, nano::account_info const & info_a, uint64_t confirmation_height)
+void nano::active_transactions::prioritize_account_for_confirmation (nano::active_transactions::prioritize_num_uncemented & cementable_frontiers_a, nano::account const & account_a, nano::account_info const & info_a, uint64_t confirmation_height)
 {
 	if (info_a.block_count > confirmation_height && !node.pending_confirmation_height.is_processing_block (info_a.head))
 	{
@@ -363,8 +415,9 @@ void nano::active_transactions::prioritize_account_for_confirmation (nano::activ
 		}
 		else
 		{
-			assert (cementable_frontiers_size_a <= max_priority_cementable_frontiers);
-			if (cementable_frontiers_size_a == max_priority_cementable_frontiers)
+			// Several threads insert, the size is only reliable under the lock
+			assert (cementable_frontiers_a.size () <= max_priority_cementable_frontiers);
+			if (cementable_frontiers_a.size () >= max_priority_cementable_frontiers)
 			{
 				// The maximum amount of frontiers stored has been reached. Check if the current frontier
 				// has more uncemented blocks than the lowest uncemented frontier in the collection if so replace it.
@@ -375,13 +428,13 @@ void nano::active_transactions::prioritize_account_for_confirmation (nano::activ
 					cementable_frontiers_a.get<1> ().erase (least_uncemented_frontier_it);
 					cementable_frontiers_a.emplace (account_a, num_uncemented);
 				}
+				// Accounts left out of a full index are found by the ledger pass following the index running out of elections
 			}
 			else
 			{
 				cementable_frontiers_a.emplace (account_a, num_uncemented);
 			}
 		}
-		cementable_frontiers_size_a = cementable_frontiers_a.size ();
 	}
 }
 
@@ -390,13 +443,6 @@ void nano::active_transactions::prioritize_frontiers_for_confirmation (nano::tra
 	// Don't try to prioritize when there are a large number of pending confirmation heights as blocks can be cemented in the meantime, making the prioritization less reliable
 	if (node.pending_confirmation_height.size () < confirmed_frontiers_max_pending_cut_off)
 	{
-		size_t priority_cementable_frontiers_size;
-		size_t priority_wallet_cementable_frontiers_size;
-		{
-			std::lock_guard<std::mutex> guard (mutex);
-			priority_cementable_frontiers_size = priority_cementable_frontiers.size ();
-			priority_wallet_cementable_frontiers_size = priority_wallet_cementable_frontiers.size ();
-		}
 		nano::timer<std::chrono::milliseconds> wallet_account_timer;
 		wallet_account_timer.start ();
 
@@ -434,15 +480,12 @@ void nano::active_transactions::prioritize_frontiers_for_confirmation (nano::tra
 						if (!node.store.account_get (transaction_a, account, info) && !node.store.confirmation_height_get (transaction_a, account, confirmation_height))
 						{
 							// If it exists in normal priority collection delete from there.
-							auto it = priority_cementable_frontiers.find (account);
-							if (it != priority_cementable_frontiers.end ())
 							{
 								std::lock_guard<std::mutex> guard (mutex);
-								priority_cementable_frontiers.erase (it);
-								priority_cementable_frontiers_size = priority_cementable_frontiers.size ();
+								priority_cementable_frontiers.erase (account);
 							}
 
-							prioritize_account_for_confirmation (priority_wallet_cementable_frontiers, priority_wallet_cementable_frontiers_size, account, info, confirmation_height);
+							prioritize_account_for_confirmation (priority_wallet_cementable_frontiers, account, info, confirmation_height);
 
 							if (wallet_account_timer.since_start () >= wallet_account_time_a)
 							{
@@ -468,36 +511,54 @@ void nano::active_transactions::prioritize_frontiers_for_confirmation (nano::tra
 			}
 		}
 
-		nano::timer<std::chrono::milliseconds> timer;
-		timer.start ();
-
-		auto i (node.store.latest_begin (transaction_a, next_frontier_account));
-		auto n (node.store.latest_end ());
-		uint64_t confirmation_height = 0;
-		for (; i != n && !stopped; ++i)
+		if (cementable_frontiers_complete)
 		{
-			auto const & account (i->first);
-			auto const & info (i->second);
-			if (priority_wallet_cementable_frontiers.find (account) == priority_wallet_cementable_frontiers.end ())
+			// The ledger index is up to date, only wallet accounts need another pass
+			skip_wallets = false;
+		}
+		else
+		{
+			if (next_frontier_account.is_zero ())
+			{
+				cementable_frontiers_dropped = false;
+			}
+			nano::timer<std::chrono::milliseconds> timer;
+			timer.start ();
+
+			auto i (node.store.latest_begin (transaction_a, next_frontier_account));
+			auto n (node.store.latest_end ());
+			uint64_t confirmation_height = 0;
+			for (; i != n && !stopped; ++i)
 			{
-				if (!node.store.confirmation_height_get (transaction_a, account, confirmation_height))
+				auto const & account (i->first);
+				auto const & info (i->second);
+				bool wallet_account;
+				{
+					std::lock_guard<std::mutex> guard (mutex);
+					wallet_account = priority_wallet_cementable_frontiers.find (account) != priority_wallet_cementable_frontiers.end ();
+				}
+				if (!wallet_account)
 				{
-					prioritize_account_for_confirmation (priority_cementable_frontiers, priority_cementable_frontiers_size, account, info, confirmation_height);
+					if (!node.store.confirmation_height_get (transaction_a, account, confirmation_height))
+					{
+						prioritize_account_for_confirmation (priority_cementable_frontiers, account, info, confirmation_height);
+					}
+				}
+				next_frontier_account = account.number () + 1;
+				if (timer.since_start () >= ledger_accounts_time_a)
+				{
+					break;
 				}
 			}
-			next_frontier_account = account.number () + 1;
-			if (timer.since_start () >= ledger_accounts_time_a)
+
+			// Go back to the beginning when we have reached the end of the accounts and start with wallet accounts next time
+			if (i == n)
 			{
-				break;
+				next_frontier_account = 0;
+				skip_wallets = false;
+				cementable_frontiers_complete = !cementable_frontiers_dropped;
 			}
 		}
-
-		// Go back to the beginning when we have reached the end of the accounts and start with wallet accounts next time
-		if (i == n)
-		{
-			next_frontier_account = 0;
-			skip_wallets = false;
-		}
 	}
 }
 
@@ -517,12 +578,86 @@ void nano::active_transactions::stop ()
 	}
 	lock.lock ();
 	roots.clear ();
+	recent_roots.clear ();
+	candidates.clear ();
 }
 
-bool nano::active_transactions::start (std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a)
+nano::election_start_result nano::active_transactions::start (std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a)
 {
 	std::lock_guard<std::mutex> lock (mutex);
-	return add (block_a, confirmation_action_a);
+	auto result (nano::election_start_result::rejected);
+	// Wallet blocks are never held back, in the same way flush_lowest never drops them
+	if (roots.size () < node.config.active_elections_size || node.wallets.watcher->is_watched (block_a->qualified_root ()) || flush_lowest ())
+	{
+		if (!add (block_a, confirmation_action_a))
+		{
+			result = nano::election_start_result::started;
+			node.stats.inc (nano::stat::type::election, nano::stat::detail::election_admitted);
+		}
+	}
+	// Nothing could be dropped to make room, wait for a slot
+	else if (!queue_candidate (block_a, confirmation_action_a))
+	{
+		result = nano::election_start_result::queued;
+	}
+	return result;
+}
+
+bool nano::active_transactions::queue_candidate (std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a)
+{
+	assert (!mutex.try_lock ());
+	auto error (true);
+	auto root (block_a->qualified_root ());
+	if (!stopped && roots.find (root) == roots.end () && candidates.find (root) == candidates.end () && confirmed_set.get<1> ().find (root) == confirmed_set.get<1> ().end ())
+	{
+		uint64_t difficulty (0);
+		auto invalid (nano::work_validate (*block_a, &difficulty));
+		(void)invalid;
+		assert (!invalid);
+		nano::uint128_t balance (0);
+		if (block_a->type () == nano::block_type::state)
+		{
+			balance = static_cast<nano::state_block const &> (*block_a).hashables.balance.number ();
+		}
+		else if (block_a->type () == nano::block_type::send)
+		{
+			balance = static_cast<nano::send_block const &> (*block_a).hashables.balance.number ();
+		}
+		candidates.insert (nano::election_candidate{ root, block_a, confirmation_action_a, difficulty, balance, std::chrono::steady_clock::now () });
+		node.stats.inc (nano::stat::type::election, nano::stat::detail::election_queued);
+		error = false;
+		if (candidates.size () > node.config.active_elections_queue_size)
+		{
+			auto lowest (std::prev (candidates.get<1> ().end ()));
+			error = lowest->root == root;
+			candidates.get<1> ().erase (lowest);
+			node.stats.inc (nano::stat::type::election, nano::stat::detail::election_evicted);
+		}
+	}
+	return error;
+}
+
+void nano::active_transactions::admit ()
+{
+	assert (!mutex.try_lock ());
+	if (!candidates.empty () && !roots.empty () && roots.size () >= node.config.active_elections_size)
+	{
+		flush_lowest ();
+	}
+	auto now (std::chrono::steady_clock::now ());
+	auto & sorted (candidates.get<1> ());
+	while (!sorted.empty () && roots.size () < node.config.active_elections_size)
+	{
+		auto candidate (*sorted.begin ());
+		sorted.erase (sorted.begin ());
+		if (!add (candidate.block, candidate.confirmation_action))
+		{
+			node.stats.inc (nano::stat::type::election, nano::stat::detail::election_admitted);
+			auto age (now - candidate.time);
+			auto bucket (age < 1s ? nano::stat::detail::election_queue_age_1s : age < 10s ? nano::stat::detail::election_queue_age_10s : age < 60s ? nano::stat::detail::election_queue_age_60s : nano::stat::detail::election_queue_age_long);
+			node.stats.inc (nano::stat::type::election, bucket);
+		}
+	}
 }
 
 bool nano::active_transactions::add (std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a)
@@ -541,7 +676,11 @@ bool nano::active_transactions::add (std::shared_ptr<nano::block> block_a, std::
 			release_assert (!error);
 			roots.insert (nano::conflict_info{ root, difficulty, difficulty, election });
 			blocks.insert (std::make_pair (hash, election));
+			election->request_tick = wheel.tick + 1;
+			wheel.schedule (root, 1);
+			recent_roots.emplace_back (election->election_start, root);
 			adjust_difficulty (hash);
+			node.block_arrival.trace (hash, nano::block_stage::election_started);
 		}
 		if (roots.size () >= node.config.active_elections_size)
 		{
@@ -552,27 +691,21 @@ bool nano::active_transactions::add (std::shared_ptr<nano::block> block_a, std::
 }
 
 // Validate a vote and apply it to the current election if one exists
-bool nano::active_transactions::vote (std::shared_ptr<nano::vote> vote_a, bool single_lock)
+bool nano::active_transactions::vote (std::shared_ptr<nano::vote> vote_a)
 {
-	std::shared_ptr<nano::election> election;
-	bool replay (false);
-	bool processed (false);
+	// Only the lookup needs the active mutex, the votes are applied under each election's own mutex
+	std::vector<std::pair<std::shared_ptr<nano::election>, nano::block_hash>> elections_l;
 	{
-		std::unique_lock<std::mutex> lock;
-		if (!single_lock)
-		{
-			lock = std::unique_lock<std::mutex> (mutex);
-		}
+		std::lock_guard<std::mutex> lock (mutex);
 		for (auto vote_block : vote_a->blocks)
 		{
-			nano::election_vote_result result;
 			if (vote_block.which ())
 			{
 				auto block_hash (boost::get<nano::block_hash> (vote_block));
 				auto existing (blocks.find (block_hash));
 				if (existing != blocks.end ())
 				{
-					result = existing->second->vote (vote_a->account, vote_a->sequence, block_hash);
+					elections_l.emplace_back (existing->second, block_hash);
 				}
 			}
 			else
@@ -581,11 +714,37 @@ bool nano::active_transactions::vote (std::shared_ptr<nano::vote> vote_a, bool s
 				auto existing (roots.find (block->qualified_root ()));
 				if (existing != roots.end ())
 				{
-					result = existing->election->vote (vote_a->account, vote_a->sequence, block->hash ());
+					elections_l.emplace_back (existing->election, block->hash ());
 				}
 			}
-			replay = replay || result.replay;
-			processed = processed || result.processed;
+		}
+	}
+	bool replay (false);
+	bool processed (false);
+	std::vector<std::shared_ptr<nano::election>> confirm_check;
+	for (auto & item : elections_l)
+	{
+		auto result (item.first->vote (vote_a->account, vote_a->sequence, item.second));
+		replay = replay || result.replay;
+		processed = processed || result.processed;
+		if (result.confirm_check)
+		{
+			confirm_check.push_back (item.first);
+		}
+	}
+	if (!confirm_check.empty ())
+	{
+		auto transaction (node.store.tx_begin_read ());
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto & election : confirm_check)
+		{
+			// The election may have finished since the lookup
+			auto existing (roots.find (election->status.winner->qualified_root ()));
+			if (existing != roots.end () && existing->election == election && !election->confirmed)
+			{
+				std::lock_guard<std::mutex> election_lock (election->mutex);
+				election->confirm_if_quorum (transaction);
+			}
 		}
 	}
 	if (processed)
@@ -627,14 +786,33 @@ void nano::active_transactions::update_difficulty (nano::block const & block_a)
 }
 
 void nano::active_transactions::adjust_difficulty (nano::block_hash const & hash_a)
+{
+	adjust_difficulty (std::vector<nano::block_hash>{ hash_a });
+}
+
+void nano::active_transactions::adjust_difficulty (std::vector<nano::block_hash> const & hashes_a)
 {
 	assert (!mutex.try_lock ());
+	std::unordered_set<nano::block_hash> processed_blocks;
+	for (auto & hash_a : hashes_a)
+	{
+		if (processed_blocks.find (hash_a) == processed_blocks.end ())
+		{
+			adjust_difficulty (hash_a, processed_blocks);
+		}
+	}
+}
+
+void nano::active_transactions::adjust_difficulty (nano::block_hash const & hash_a, std::unordered_set<nano::block_hash> & processed_blocks)
+{
 	std::deque<std::pair<nano::block_hash, int64_t>> remaining_blocks;
 	remaining_blocks.emplace_back (hash_a, 0);
-	std::unordered_set<nano::block_hash> processed_blocks;
 	std::vector<std::pair<nano::qualified_root, int64_t>> elections_list;
 	double sum (0.);
-	while (!remaining_blocks.empty ())
+	// Blocks visited by earlier walks of the same batch do not count towards this walk's bound
+	auto processed_begin (processed_blocks.size ());
+	// Very long dependency graphs are only adjusted up to a bounded number of blocks, the rest is reached by later adjustments
+	while (!remaining_blocks.empty () && processed_blocks.size () - processed_begin < max_adjust_difficulty_blocks)
 	{
 		auto const & item (remaining_blocks.front ());
 		auto hash (item.first);
@@ -703,22 +881,49 @@ void nano::active_transactions::update_active_difficulty (std::unique_lock<std::
 {
 	assert (lock_a.mutex () == &mutex && lock_a.owns_lock ());
 	double multiplier (1.);
+	auto min_election_time (std::chrono::milliseconds (node.network_params.network.request_interval_ms));
+	auto cutoff (std::chrono::steady_clock::now () - min_election_time);
+	while (!recent_roots.empty () && recent_roots.front ().first < cutoff)
+	{
+		recent_roots.pop_front ();
+	}
 	if (!roots.empty ())
 	{
-		std::vector<uint64_t> active_root_difficulties;
-		active_root_difficulties.reserve (roots.size ());
-		auto min_election_time (std::chrono::milliseconds (node.network_params.network.request_interval_ms));
-		auto cutoff (std::chrono::steady_clock::now () - min_election_time);
-		for (auto & root : roots)
+		// Ranks of elections too recent to count, only these are visited instead of every root
+		auto & sorted_roots (roots.get<1> ());
+		std::vector<size_t> skipped;
+		skipped.reserve (recent_roots.size ());
+		for (auto & recent : recent_roots)
 		{
-			if (!root.election->confirmed && !root.election->stopped && root.election->election_start < cutoff)
+			auto existing (roots.find (recent.second));
+			if (existing != roots.end () && existing->election->election_start >= cutoff)
 			{
-				active_root_difficulties.push_back (root.adjusted_difficulty);
+				skipped.push_back (sorted_roots.rank (roots.project<1> (existing)));
 			}
 		}
-		if (!active_root_difficulties.empty ())
+		std::sort (skipped.begin (), skipped.end ());
+		skipped.erase (std::unique (skipped.begin (), skipped.end ()), skipped.end ());
+		if (skipped.size () < roots.size ())
 		{
-			multiplier = nano::difficulty::to_multiplier (active_root_difficulties[active_root_difficulties.size () / 2], node.network_params.network.publish_threshold);
+			// Translate the median of the remaining elections into a rank of the whole index
+			auto position ((roots.size () - skipped.size ()) / 2);
+			for (auto rank : skipped)
+			{
+				if (rank <= position)
+				{
+					++position;
+				}
+			}
+			// Elections finished since their last request pass are still in the index until erased, use the next one instead
+			auto median (sorted_roots.nth (position));
+			while (median != sorted_roots.end () && (median->election->confirmed || median->election->stopped))
+			{
+				++median;
+			}
+			if (median != sorted_roots.end ())
+			{
+				multiplier = nano::difficulty::to_multiplier (median->adjusted_difficulty, node.network_params.network.publish_threshold);
+			}
 		}
 	}
 	assert (multiplier >= 1);
@@ -728,12 +933,11 @@ void nano::active_transactions::update_active_difficulty (std::unique_lock<std::
 	assert (difficulty >= node.network_params.network.publish_threshold);
 
 	trended_active_difficulty = difficulty;
-	node.observers.difficulty.notify (trended_active_difficulty);
+	node.observers.difficulty.notify (difficulty);
 }
 
 uint64_t nano::active_transactions::active_difficulty ()
 {
-	std::lock_guard<std::mutex> lock (mutex);
 	return trended_active_difficulty;
 }
 
@@ -743,14 +947,10 @@ uint64_t nano::active_transactions::limited_active_difficulty ()
 }
 
 // List of active blocks in elections
-std::deque<std::shared_ptr<nano::block>> nano::active_transactions::list_blocks (bool single_lock)
+std::deque<std::shared_ptr<nano::block>> nano::active_transactions::list_blocks ()
 {
 	std::deque<std::shared_ptr<nano::block>> result;
-	std::unique_lock<std::mutex> lock;
-	if (!single_lock)
-	{
-		lock = std::unique_lock<std::mutex> (mutex);
-	}
+	std::lock_guard<std::mutex> lock (mutex);
 	for (auto i (roots.begin ()), n (roots.end ()); i != n; ++i)
 	{
 		result.push_back (i->election->status.winner);
@@ -792,7 +992,7 @@ void nano::active_transactions::erase (nano::block const & block_a)
 	}
 }
 
-void nano::active_transactions::flush_lowest ()
+bool nano::active_transactions::flush_lowest ()
 {
 	size_t count (0);
 	assert (!roots.empty ());
@@ -808,6 +1008,7 @@ void nano::active_transactions::flush_lowest ()
 				election->stop ();
 				election->clear_blocks ();
 				election->clear_dependent ();
+				node.stats.inc (nano::stat::type::election, nano::stat::detail::election_dropped);
 				count++;
 			}
 			else
@@ -820,6 +1021,7 @@ void nano::active_transactions::flush_lowest ()
 			break;
 		}
 	}
+	return count != 0;
 }
 
 bool nano::active_transactions::empty ()
@@ -872,6 +1074,85 @@ void nano::active_transactions::confirm_block (nano::transaction const & transac
 		nano::account pending_account (0);
 		node.process_confirmed_data (transaction_a, block_a, hash, sideband_a, account, amount, is_state_send, pending_account);
 		node.observers.blocks.notify (nano::election_status{ block_a, 0, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ()), std::chrono::duration_values<std::chrono::milliseconds>::zero (), nano::election_status_type::inactive_confirmation_height }, account, amount, is_state_send);
+		node.block_arrival.trace (hash, nano::block_stage::dispatched);
+	}
+}
+
+void nano::active_transactions::add_uncemented (nano::transaction const & transaction_a, nano::account const & account_a)
+{
+	add_uncemented (transaction_a, std::unordered_map<nano::account, uint64_t>{ { account_a, 1 } });
+}
+
+void nano::active_transactions::add_uncemented (nano::transaction const & transaction_a, std::unordered_map<nano::account, uint64_t> const & accounts_a)
+{
+	std::vector<nano::account> untracked;
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		for (auto & account : accounts_a)
+		{
+			auto tracked (false);
+			for (auto cementable_frontiers : { &priority_wallet_cementable_frontiers, &priority_cementable_frontiers })
+			{
+				auto existing (cementable_frontiers->find (account.first));
+				if (existing != cementable_frontiers->end ())
+				{
+					auto count (account.second);
+					cementable_frontiers->modify (existing, [count](nano::cementable_account & info_a) {
+						info_a.blocks_uncemented += count;
+					});
+					tracked = true;
+					break;
+				}
+			}
+			if (!tracked)
+			{
+				untracked.push_back (account.first);
+			}
+		}
+	}
+	if (!untracked.empty ())
+	{
+		if (node.bootstrap_initiator.in_progress ())
+		{
+			// Looking up every new account would slow down bootstrap, leave them to another ledger pass
+			cementable_frontiers_dropped = true;
+			cementable_frontiers_complete = false;
+		}
+		else
+		{
+			// Accounts not in the index yet need their uncemented count from the ledger
+			for (auto & account : untracked)
+			{
+				nano::account_info info;
+				uint64_t confirmation_height;
+				if (!node.store.account_get (transaction_a, account, info) && !node.store.confirmation_height_get (transaction_a, account, confirmation_height))
+				{
+					prioritize_account_for_confirmation (priority_cementable_frontiers, account, info, confirmation_height);
+				}
+			}
+		}
+	}
+}
+
+void nano::active_transactions::remove_uncemented (nano::account const & account_a, uint64_t cemented_a)
+{
+	std::lock_guard<std::mutex> guard (mutex);
+	for (auto cementable_frontiers : { &priority_wallet_cementable_frontiers, &priority_cementable_frontiers })
+	{
+		auto existing (cementable_frontiers->find (account_a));
+		if (existing != cementable_frontiers->end ())
+		{
+			if (existing->blocks_uncemented > cemented_a)
+			{
+				cementable_frontiers->modify (existing, [cemented_a](nano::cementable_account & info_a) {
+					info_a.blocks_uncemented -= cemented_a;
+				});
+			}
+			else
+			{
+				cementable_frontiers->erase (existing);
+			}
+		}
 	}
 }
 
@@ -893,6 +1174,77 @@ boost::circular_buffer<double> nano::active_transactions::difficulty_trend ()
 	return multipliers_cb;
 }
 
+bool nano::election_candidate_priority::operator() (nano::election_candidate const & lhs, nano::election_candidate const & rhs) const
+{
+	auto result (false);
+	if (lhs.difficulty != rhs.difficulty)
+	{
+		result = lhs.difficulty > rhs.difficulty;
+	}
+	else if (lhs.balance != rhs.balance)
+	{
+		result = lhs.balance > rhs.balance;
+	}
+	else
+	{
+		result = lhs.time < rhs.time;
+	}
+	return result;
+}
+
+nano::request_wheel::request_wheel (size_t slots_a) :
+slots (std::max<size_t> (1, slots_a))
+{
+}
+
+void nano::request_wheel::schedule (nano::qualified_root const & root_a, uint64_t ticks_a)
+{
+	auto due (tick + std::max<uint64_t> (1, ticks_a));
+	if (due - tick < slots.size ())
+	{
+		slots[due % slots.size ()].push_back (root_a);
+		++slots_size;
+	}
+	else
+	{
+		overflow.emplace (due, root_a);
+	}
+}
+
+void nano::request_wheel::advance (std::deque<nano::qualified_root> & due_a)
+{
+	++tick;
+	auto & slot (slots[tick % slots.size ()]);
+	due_a.insert (due_a.end (), slot.begin (), slot.end ());
+	slots_size -= slot.size ();
+	slot.clear ();
+	// Cascade overflow entries that now fit in the wheel, the slot just emptied is a full revolution away
+	while (!overflow.empty () && overflow.begin ()->first - tick < slots.size ())
+	{
+		auto due (overflow.begin ()->first);
+		if (due == tick)
+		{
+			due_a.push_back (overflow.begin ()->second);
+		}
+		else
+		{
+			slots[due % slots.size ()].push_back (overflow.begin ()->second);
+			++slots_size;
+		}
+		overflow.erase (overflow.begin ());
+	}
+}
+
+size_t nano::request_wheel::size () const
+{
+	return slots_size + overflow.size ();
+}
+
+size_t nano::request_wheel::overflow_size () const
+{
+	return overflow.size ();
+}
+
 nano::cementable_account::cementable_account (nano::account const & account_a, size_t blocks_uncemented_a) :
 account (account_a), blocks_uncemented (blocks_uncemented_a)
 {
@@ -905,18 +1257,30 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (active_transaction
 	size_t roots_count = 0;
 	size_t blocks_count = 0;
 	size_t confirmed_count = 0;
+	size_t wheel_count = 0;
+	size_t wheel_overflow_count = 0;
+	size_t due_count = 0;
+	size_t candidates_count = 0;
 
 	{
 		std::lock_guard<std::mutex> guard (active_transactions.mutex);
 		roots_count = active_transactions.roots.size ();
 		blocks_count = active_transactions.blocks.size ();
 		confirmed_count = active_transactions.confirmed.size ();
+		wheel_count = active_transactions.wheel.size ();
+		wheel_overflow_count = active_transactions.wheel.overflow_size ();
+		due_count = active_transactions.due.size ();
+		candidates_count = active_transactions.candidates.size ();
 	}
 
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "roots", roots_count, sizeof (decltype (active_transactions.roots)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "blocks", blocks_count, sizeof (decltype (active_transactions.blocks)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "confirmed", confirmed_count, sizeof (decltype (active_transactions.confirmed)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "request_wheel", wheel_count - wheel_overflow_count, sizeof (nano::qualified_root) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "request_wheel_overflow", wheel_overflow_count, sizeof (std::pair<uint64_t, nano::qualified_root>) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "candidates", candidates_count, sizeof (decltype (active_transactions.candidates)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "request_due", due_count, sizeof (decltype (active_transactions.due)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "priority_wallet_cementable_frontiers_count", active_transactions.priority_wallet_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "priority_cementable_frontiers_count", active_transactions.priority_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	return composite;
@@ -6,9 +6,11 @@
 
 #include <boost/circular_buffer.hpp>
 #include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
+#include <boost/multi_index/ranked_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/pool/pool_alloc.hpp>
 #include <boost/thread/thread.hpp>
@@ -16,6 +18,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <map>
 #include <memory>
 #include <queue>
 #include <set>
@@ -40,6 +43,13 @@ public:
 	std::shared_ptr<nano::election> election;
 };
 
+enum class election_start_result
+{
+	started, // An election is active for the block
+	queued, // No room for another election, the block waits in the admission queue
+	rejected // Already active or recently confirmed, evicted from the admission queue, or stopped
+};
+
 enum class election_status_type : uint8_t
 {
 	ongoing = 0,
@@ -74,6 +84,47 @@ public:
 	nano::uint512_union root;
 };
 
+/** A block waiting for an election slot while active elections are full */
+class election_candidate final
+{
+public:
+	nano::qualified_root root;
+	std::shared_ptr<nano::block> block;
+	std::function<void(std::shared_ptr<nano::block>)> confirmation_action;
+	uint64_t difficulty;
+	nano::uint128_t balance;
+	std::chrono::steady_clock::time_point time;
+};
+
+/** Admission order of candidates, highest difficulty first then highest balance then longest waiting */
+class election_candidate_priority final
+{
+public:
+	bool operator() (nano::election_candidate const &, nano::election_candidate const &) const;
+};
+
+/**
+ * Timing wheel of roots due for confirmation requests, one slot per request loop pass.
+ * Roots due further ahead than the wheel spans wait in an overflow level and move to a slot once it comes in to range.
+ */
+class request_wheel final
+{
+public:
+	explicit request_wheel (size_t);
+	/** Schedules \p root_a \p ticks_a passes from now, at least one */
+	void schedule (nano::qualified_root const &, uint64_t ticks_a);
+	/** Moves to the next pass and appends the roots due at it to \p due_a */
+	void advance (std::deque<nano::qualified_root> & due_a);
+	size_t size () const;
+	size_t overflow_size () const;
+	uint64_t tick{ 0 };
+
+private:
+	std::vector<std::vector<nano::qualified_root>> slots;
+	std::multimap<uint64_t, nano::qualified_root> overflow;
+	size_t slots_size{ 0 };
+};
+
 // Core class for determining consensus
 // Holds all active blocks i.e. recently added blocks that need confirmation
 class active_transactions final
@@ -84,23 +135,25 @@ public:
 	// Start an election for a block
 	// Call action with confirmed block, may be different than what we started with
 	// clang-format off
-	bool start (std::shared_ptr<nano::block>, std::function<void(std::shared_ptr<nano::block>)> const & = [](std::shared_ptr<nano::block>) {});
+	nano::election_start_result start (std::shared_ptr<nano::block>, std::function<void(std::shared_ptr<nano::block>)> const & = [](std::shared_ptr<nano::block>) {});
 	// clang-format on
 	// If this returns true, the vote is a replay
 	// If this returns false, the vote may or may not be a replay
-	bool vote (std::shared_ptr<nano::vote>, bool = false);
+	bool vote (std::shared_ptr<nano::vote>);
 	// Is the root of this block in the roots container
 	bool active (nano::block const &);
 	bool active (nano::qualified_root const &);
 	void update_difficulty (nano::block const &);
 	void adjust_difficulty (nano::block_hash const &);
+	/** Adjusts the difficulty of the dependency graphs around each hash, traversing a graph reached from several of them once */
+	void adjust_difficulty (std::vector<nano::block_hash> const &);
 	void update_active_difficulty (std::unique_lock<std::mutex> &);
 	uint64_t active_difficulty ();
 	uint64_t limited_active_difficulty ();
-	std::deque<std::shared_ptr<nano::block>> list_blocks (bool = false);
+	std::deque<std::shared_ptr<nano::block>> list_blocks ();
 	void erase (nano::block const &);
-	//drop 2 from roots based on adjusted_difficulty
-	void flush_lowest ();
+	//drop 2 from roots based on adjusted_difficulty, returns true if any were dropped
+	bool flush_lowest ();
 	bool empty ();
 	size_t size ();
 	void stop ();
@@ -111,7 +164,7 @@ public:
 	boost::multi_index::indexed_by<
 	boost::multi_index::hashed_unique<
 	boost::multi_index::member<nano::conflict_info, nano::qualified_root, &nano::conflict_info::root>>,
-	boost::multi_index::ordered_non_unique<
+	boost::multi_index::ranked_non_unique<
 	boost::multi_index::member<nano::conflict_info, uint64_t, &nano::conflict_info::adjusted_difficulty>,
 	std::greater<uint64_t>>>>
 	roots;
@@ -127,8 +180,18 @@ public:
 	static unsigned constexpr high_confirmation_request_count = 2;
 	size_t long_unconfirmed_size = 0;
 	static size_t constexpr max_broadcast_queue = 1000;
+	// Maximum number of due elections handled by one request loop pass, the rest wait for the next pass
+	static size_t constexpr max_requests_per_pass = 2 * max_broadcast_queue;
+	// Maximum number of blocks visited by each walk when adjusting difficulty along dependencies
+	static size_t constexpr max_adjust_difficulty_blocks = 4 * 1024;
 	boost::circular_buffer<double> multipliers_cb;
-	uint64_t trended_active_difficulty;
+	std::atomic<uint64_t> trended_active_difficulty;
+	/** Counts a block processed for \p account_a towards the uncemented frontier index */
+	void add_uncemented (nano::transaction const &, nano::account const &);
+	/** Counts the blocks processed per account in a block processor batch towards the uncemented frontier index */
+	void add_uncemented (nano::transaction const &, std::unordered_map<nano::account, uint64_t> const &);
+	/** Removes blocks of \p account_a cemented by the confirmation height processor from the uncemented frontier index */
+	void remove_uncemented (nano::account const &, uint64_t);
 	size_t priority_cementable_frontiers_size ();
 	size_t priority_wallet_cementable_frontiers_size ();
 	boost::circular_buffer<double> difficulty_trend ();
@@ -138,8 +201,26 @@ private:
 	// clang-format off
 	bool add (std::shared_ptr<nano::block>, std::function<void(std::shared_ptr<nano::block>)> const & = [](std::shared_ptr<nano::block>) {});
 	// clang-format on
+	/** Queues a block for an election once there is room, evicting the lowest priority candidate beyond active_elections_queue_size */
+	bool queue_candidate (std::shared_ptr<nano::block>, std::function<void(std::shared_ptr<nano::block>)> const &);
+	/** Starts elections for the highest priority candidates while there is room */
+	void admit ();
+	boost::multi_index_container<
+	nano::election_candidate,
+	boost::multi_index::indexed_by<
+	boost::multi_index::hashed_unique<boost::multi_index::member<nano::election_candidate, nano::qualified_root, &nano::election_candidate::root>>,
+	boost::multi_index::ordered_non_unique<boost::multi_index::identity<nano::election_candidate>, nano::election_candidate_priority>>>
+	candidates;
 	void request_loop ();
 	void request_confirm (std::unique_lock<std::mutex> &);
+	/** Passes until an election that has had \p request_count_a confirmation requests is due again */
+	uint64_t request_delay (unsigned request_count_a) const;
+	nano::request_wheel wheel{ 64 };
+	void adjust_difficulty (nano::block_hash const &, std::unordered_set<nano::block_hash> &);
+	/** Roots of elections started within the last request interval, these do not count towards the active difficulty yet */
+	std::deque<std::pair<std::chrono::steady_clock::time_point, nano::qualified_root>> recent_roots;
+	/** Roots whose elections are due, in the order they became due */
+	std::deque<nano::qualified_root> due;
 	void confirm_frontiers (nano::transaction const &);
 	nano::account next_frontier_account{ 0 };
 	std::chrono::steady_clock::time_point next_frontier_check{ std::chrono::steady_clock::now () };
@@ -167,13 +248,19 @@ private:
 	std::unordered_map<nano::uint256_union, nano::account> next_wallet_frontier_accounts;
 	bool frontiers_fully_confirmed{ false };
 	bool skip_wallets{ false };
-	void prioritize_account_for_confirmation (prioritize_num_uncemented &, size_t &, nano::account const &, nano::account_info const &, uint64_t);
+	/** Set after a full ledger pass, from then on the frontier index is maintained as blocks are processed and cemented */
+	std::atomic<bool> cementable_frontiers_complete{ false };
+	/** Set when an account was left out of the frontier index during bootstrap, requiring another ledger pass */
+	std::atomic<bool> cementable_frontiers_dropped{ false };
+	void prioritize_account_for_confirmation (prioritize_num_uncemented &, nano::account const &, nano::account_info const &, uint64_t);
 	static size_t constexpr max_priority_cementable_frontiers{ 100000 };
 	static size_t constexpr confirmed_frontiers_max_pending_cut_off{ 1000 };
 	boost::thread thread;
 
+	friend std::unique_ptr<seq_con_info_component> collect_seq_con_info (active_transactions &, const std::string &);
 	friend class confirmation_height_prioritize_frontiers_Test;
 	friend class confirmation_height_prioritize_frontiers_overwrite_Test;
+	friend class confirmation_height_prioritize_frontiers_incremental_Test;
 	friend class confirmation_height_many_accounts_single_confirmation_Test;
 	friend class confirmation_height_many_accounts_many_confirmations_Test;
 	friend class confirmation_height_long_chains_Test;
@@ -28,6 +28,7 @@ void nano::block_processor::stop ()
 	{
 		std::lock_guard<std::mutex> lock (mutex);
 		stopped = true;
+		capacity_waiters.clear ();
 	}
 	condition.notify_all ();
 }
@@ -45,7 +46,7 @@ void nano::block_processor::flush ()
 size_t nano::block_processor::size ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
-	return (blocks.size () + state_blocks.size () + forced.size ());
+	return (blocks.size () + state_blocks.size () + forced.size () + deferred.size ());
 }
 
 bool nano::block_processor::full ()
@@ -58,6 +59,61 @@ bool nano::block_processor::half_full ()
 	return size () > node.flags.block_processor_full_size / 2;
 }
 
+size_t nano::block_processor::capacity ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return capacity_impl ();
+}
+
+size_t nano::block_processor::capacity_impl ()
+{
+	auto target (std::max<size_t> (1, node.flags.block_processor_full_size / 2));
+	auto reference (node.config.block_processor_batch_max_time / 10);
+	if (write_latency > reference && reference.count () > 0)
+	{
+		// Writes are backing up, queue less so memory does not grow faster than the disk drains it
+		target = std::max<size_t> ({ 1, target / 4, static_cast<size_t> (target * reference.count () / write_latency.count ()) });
+	}
+	auto size_l (blocks.size () + state_blocks.size () + forced.size () + deferred.size ());
+	return target > size_l ? target - size_l : 0;
+}
+
+void nano::block_processor::wait_capacity (std::function<void()> const & callback_a)
+{
+	auto ready (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!stopped)
+		{
+			ready = capacity_impl () > 0;
+			if (!ready)
+			{
+				capacity_waiters.push_back (callback_a);
+			}
+		}
+	}
+	if (ready)
+	{
+		node.background (callback_a);
+	}
+}
+
+void nano::block_processor::notify_capacity (std::unique_lock<std::mutex> & lock_a)
+{
+	assert (lock_a.owns_lock ());
+	if (!capacity_waiters.empty () && capacity_impl () > 0)
+	{
+		std::deque<std::function<void()>> waiters;
+		waiters.swap (capacity_waiters);
+		lock_a.unlock ();
+		for (auto & waiter : waiters)
+		{
+			node.background (waiter);
+		}
+		lock_a.lock ();
+	}
+}
+
 void nano::block_processor::add (std::shared_ptr<nano::block> block_a, uint64_t origination)
 {
 	nano::unchecked_info info (block_a, 0, origination, nano::signature_verification::unknown);
@@ -120,9 +176,11 @@ void nano::block_processor::process_blocks ()
 			process_batch (lock);
 			lock.lock ();
 			active = false;
+			notify_capacity (lock);
 		}
 		else
 		{
+			notify_capacity (lock);
 			condition.notify_all ();
 			condition.wait (lock);
 		}
@@ -155,10 +213,16 @@ void nano::block_processor::verify_state_blocks (nano::transaction const & trans
 	for (auto i (0); i < max_count && !state_blocks.empty (); i++)
 	{
 		auto & item (state_blocks.front ());
-		if (!node.ledger.store.block_exists (transaction_a, item.block->type (), item.block->hash ()))
+		auto hash (item.block->hash ());
+		if (!node.ledger.store.block_exists (transaction_a, item.block->type (), hash))
 		{
 			items.push_back (std::move (item));
 		}
+		else
+		{
+			blocks_hashes.erase (hash);
+			release_dependents (hash);
+		}
 		state_blocks.pop_front ();
 	}
 	lock_a.unlock ();
@@ -229,6 +293,12 @@ void nano::block_processor::verify_state_blocks (nano::transaction const & trans
 				item.verified = nano::signature_verification::valid;
 				blocks.push_back (std::move (item));
 			}
+			else
+			{
+				// Dropped for an invalid signature, nothing queued may keep waiting on it
+				blocks_hashes.erase (hashes[i]);
+				release_dependents (hashes[i]);
+			}
 			items.pop_front ();
 		}
 		if (node.config.logging.timing_logging ())
@@ -261,10 +331,13 @@ void nano::block_processor::process_batch (std::unique_lock<std::mutex> & lock_a
 		}
 	}
 	lock_a.unlock ();
+	auto write_start (std::chrono::steady_clock::now ());
 	auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
 	auto transaction (node.store.tx_begin_write ({ nano::tables::accounts_v0, nano::tables::accounts_v1, nano::tables::cached_counts, nano::tables::change_blocks, nano::tables::frontiers, nano::tables::open_blocks, nano::tables::pending_v0, nano::tables::pending_v1, nano::tables::receive_blocks, nano::tables::representation, nano::tables::send_blocks, nano::tables::state_blocks_v0, nano::tables::state_blocks_v1, nano::tables::unchecked }, { nano::tables::confirmation_height }));
+	auto write_wait (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - write_start));
 	timer_l.restart ();
 	lock_a.lock ();
+	write_latency = (write_latency * 3 + write_wait) / 4;
 	// Processing blocks
 	auto first_time (true);
 	unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
@@ -297,6 +370,14 @@ void nano::block_processor::process_batch (std::unique_lock<std::mutex> & lock_a
 		{
 			info = blocks.front ();
 			blocks.pop_front ();
+			auto dependency (queued_dependency (*info.block));
+			if (!dependency.is_zero ())
+			{
+				// Hold the block until the block it builds on has been processed instead of sending it to unchecked
+				deferred.emplace (dependency, std::move (info));
+				node.stats.inc (nano::stat::type::block, nano::stat::detail::dependency_deferred);
+				continue;
+			}
 			blocks_hashes.erase (info.block->hash ());
 		}
 		else
@@ -350,6 +431,10 @@ void nano::block_processor::process_batch (std::unique_lock<std::mutex> & lock_a
 		number_of_blocks_processed++;
 		process_one (transaction, info);
 		lock_a.lock ();
+		if (!force)
+		{
+			release_dependents (hash);
+		}
 		/* Verify more state blocks if blocks deque is empty
 		 Because verification is long process, avoid large deque verification inside of write transaction */
 		if (blocks.empty () && !state_blocks.empty ())
@@ -359,6 +444,12 @@ void nano::block_processor::process_batch (std::unique_lock<std::mutex> & lock_a
 	}
 	awaiting_write = false;
 	lock_a.unlock ();
+	if (!uncemented.empty ())
+	{
+		// One update of the uncemented frontier index per batch
+		node.active.add_uncemented (transaction, uncemented);
+		uncemented.clear ();
+	}
 
 	if (node.config.logging.timing_logging () && number_of_blocks_processed != 0)
 	{
@@ -366,6 +457,41 @@ void nano::block_processor::process_batch (std::unique_lock<std::mutex> & lock_a
 	}
 }
 
+nano::block_hash nano::block_processor::queued_dependency (nano::block const & block_a)
+{
+	assert (!mutex.try_lock ());
+	nano::block_hash result (0);
+	auto hash (block_a.hash ());
+	auto queued = [this, &hash](nano::block_hash const & dependency_a) {
+		return !dependency_a.is_zero () && dependency_a != hash && blocks_hashes.find (dependency_a) != blocks_hashes.end ();
+	};
+	if (queued (block_a.previous ()))
+	{
+		result = block_a.previous ();
+	}
+	else if (queued (block_a.source ()))
+	{
+		result = block_a.source ();
+	}
+	else if (block_a.type () == nano::block_type::state && queued (block_a.link ()))
+	{
+		result = block_a.link ();
+	}
+	return result;
+}
+
+void nano::block_processor::release_dependents (nano::block_hash const & hash_a)
+{
+	assert (!mutex.try_lock ());
+	auto range (deferred.equal_range (hash_a));
+	for (auto i (range.first); i != range.second; ++i)
+	{
+		// Dependents go to the front so they are applied in the same write transaction as their dependency
+		blocks.push_front (std::move (i->second));
+	}
+	deferred.erase (range.first, range.second);
+}
+
 void nano::block_processor::process_live (nano::block_hash const & hash_a, std::shared_ptr<nano::block> block_a, const bool watch_work_a)
 {
 	// Start collecting quorum on block
@@ -424,8 +550,13 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			}
 			if (info_a.modified > nano::seconds_since_epoch () - 300 && node.block_arrival.recent (hash))
 			{
+				node.block_arrival.trace (hash, nano::block_stage::processed);
 				process_live (hash, info_a.block, watch_work_a);
 			}
+			if (node.config.frontiers_confirmation != nano::frontiers_confirmation_mode::disabled)
+			{
+				++uncemented[result.account];
+			}
 			queue_unchecked (transaction_a, hash);
 			break;
 		}
@@ -442,6 +573,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			}
 			node.store.unchecked_put (transaction_a, nano::unchecked_key (info_a.block->previous (), hash), info_a);
 			node.gap_cache.add (transaction_a, hash);
+			node.stats.inc (nano::stat::type::block, nano::stat::detail::gap_previous);
 			break;
 		}
 		case nano::process_result::gap_source:
@@ -457,6 +589,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			}
 			node.store.unchecked_put (transaction_a, nano::unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash), info_a);
 			node.gap_cache.add (transaction_a, hash);
+			node.stats.inc (nano::stat::type::block, nano::stat::detail::gap_source);
 			break;
 		}
 		case nano::process_result::old:
@@ -11,7 +11,9 @@
 #include <boost/multi_index_container.hpp>
 
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace nano
@@ -41,6 +43,10 @@ public:
 	size_t size ();
 	bool full ();
 	bool half_full ();
+	/** Blocks that can still be queued before bootstrap should pause, shrinks while database writes are slow */
+	size_t capacity ();
+	/** Runs \p callback_a in a background thread once there is capacity, immediately if there already is */
+	void wait_capacity (std::function<void()> const &);
 	void add (nano::unchecked_info const &);
 	void add (std::shared_ptr<nano::block>, uint64_t = 0);
 	void force (std::shared_ptr<nano::block>);
@@ -59,6 +65,11 @@ private:
 	void verify_state_blocks (nano::transaction const & transaction_a, std::unique_lock<std::mutex> &, size_t = std::numeric_limits<size_t>::max ());
 	void process_batch (std::unique_lock<std::mutex> &);
 	void process_live (nano::block_hash const &, std::shared_ptr<nano::block>, const bool = false);
+	/** First dependency of the block that is still queued, zero if it can be applied now */
+	nano::block_hash queued_dependency (nano::block const &);
+	void release_dependents (nano::block_hash const &);
+	size_t capacity_impl ();
+	void notify_capacity (std::unique_lock<std::mutex> &);
 	bool stopped;
 	bool active;
 	bool awaiting_write{ false };
@@ -66,7 +77,14 @@ private:
 	std::deque<nano::unchecked_info> state_blocks;
 	std::deque<nano::unchecked_info> blocks;
 	std::unordered_set<nano::block_hash> blocks_hashes;
+	/** Blocks drawn before a block they depend on, keyed by that dependency */
+	std::unordered_multimap<nano::block_hash, nano::unchecked_info> deferred;
 	std::deque<std::shared_ptr<nano::block>> forced;
+	std::deque<std::function<void()>> capacity_waiters;
+	/** Blocks processed per account, only accessed under the write transaction */
+	std::unordered_map<nano::account, uint64_t> uncemented;
+	/** Moving average of the time spent waiting for the write queue and opening the write transaction */
+	std::chrono::milliseconds write_latency{ 0 };
 	boost::multi_index_container<
 	nano::rolled_hash,
 	boost::multi_index::indexed_by<
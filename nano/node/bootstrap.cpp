@@ -15,11 +15,25 @@ constexpr double bootstrap_minimum_blocks_per_sec = 10.0;
 constexpr double bootstrap_minimum_elapsed_seconds_blockrate = 0.02;
 constexpr double bootstrap_minimum_frontier_blocks_per_sec = 1000.0;
 constexpr unsigned bootstrap_frontier_retry_limit = 16;
+constexpr unsigned bootstrap_frontier_ranges_max = 8;
+constexpr uint32_t bootstrap_frontier_range_chunk = 16 * 1024;
 constexpr double bootstrap_minimum_termination_time_sec = 30.0;
 constexpr unsigned bootstrap_max_new_connections = 10;
+constexpr unsigned bootstrap_pull_batch_max = 8;
+constexpr size_t bootstrap_pull_credits = 256;
+constexpr size_t bootstrap_pending_batch_max = 64;
+constexpr std::chrono::minutes bootstrap_lazy_pending_age (15);
+constexpr std::chrono::seconds bootstrap_checkpoint_interval (60);
 constexpr unsigned bulk_push_cost_limit = 200;
 
 size_t constexpr nano::frontier_req_client::size_frontier;
+size_t constexpr nano::frontier_req_client::buffer_size;
+size_t constexpr nano::bulk_pull_account_client::size_pending;
+size_t constexpr nano::bulk_pull_account_client::buffer_size;
+size_t constexpr nano::frontier_req_server::frontiers_per_write;
+size_t constexpr nano::bootstrap_server::realtime_buffer_size;
+size_t constexpr nano::lazy_block_filter::bucket_size;
+size_t constexpr nano::lazy_block_filter::initial_buckets;
 
 nano::bootstrap_client::bootstrap_client (std::shared_ptr<nano::node> node_a, std::shared_ptr<nano::bootstrap_attempt> attempt_a, std::shared_ptr<nano::transport::channel_tcp> channel_a) :
 node (node_a),
@@ -29,7 +43,8 @@ receive_buffer (std::make_shared<std::vector<uint8_t>> ()),
 start_time (std::chrono::steady_clock::now ()),
 block_count (0),
 pending_stop (false),
-hard_stop (false)
+hard_stop (false),
+throttled_ms (0)
 {
 	++attempt->connections;
 	receive_buffer->resize (256);
@@ -37,6 +52,23 @@ hard_stop (false)
 
 nano::bootstrap_client::~bootstrap_client ()
 {
+	std::deque<nano::pull_info> pulls_l;
+	{
+		std::lock_guard<std::mutex> lock (pulls_mutex);
+		pulls_l.swap (pulls);
+	}
+	if (!pulls_l.empty ())
+	{
+		// Hand unserved pulls back in an external thread, the last reference can be released with the attempt mutex held
+		auto attempt_l (attempt);
+		node->background ([attempt_l, pulls_l]() mutable {
+			{
+				std::lock_guard<std::mutex> lock (attempt_l->mutex);
+				attempt_l->return_pulls (pulls_l);
+			}
+			attempt_l->condition.notify_all ();
+		});
+	}
 	--attempt->connections;
 }
 
@@ -63,9 +95,13 @@ void nano::bootstrap_client::stop (bool force)
 void nano::frontier_req_client::run ()
 {
 	nano::frontier_req request;
-	request.start.clear ();
+	request.start = cursor.is_zero () ? cursor : cursor.number () + 1;
 	request.age = std::numeric_limits<decltype (request.age)>::max ();
-	request.count = std::numeric_limits<decltype (request.count)>::max ();
+	// A bounded range is requested in chunks so a peer never streams far past its end
+	request.count = end.is_zero () ? std::numeric_limits<decltype (request.count)>::max () : bootstrap_frontier_range_chunk;
+	request_count = request.count;
+	request_received = 0;
+	buffer_used = 0;
 	auto this_l (shared_from_this ());
 	connection->channel->send (
 	request, [this_l](boost::system::error_code const & ec, size_t size_a) {
@@ -89,11 +125,14 @@ std::shared_ptr<nano::bootstrap_client> nano::bootstrap_client::shared ()
 	return shared_from_this ();
 }
 
-nano::frontier_req_client::frontier_req_client (std::shared_ptr<nano::bootstrap_client> connection_a) :
+nano::frontier_req_client::frontier_req_client (std::shared_ptr<nano::bootstrap_client> connection_a, nano::account const & cursor_a, nano::account const & end_a) :
 connection (connection_a),
-current (0),
+buffer (std::make_shared<std::vector<uint8_t>> (buffer_size)),
+current (cursor_a),
 count (0),
-bulk_push_cost (0)
+bulk_push_cost (0),
+cursor (cursor_a),
+end (end_a)
 {
 	auto transaction (connection->node->store.tx_begin_read ());
 	next (transaction);
@@ -106,20 +145,8 @@ nano::frontier_req_client::~frontier_req_client ()
 void nano::frontier_req_client::receive_frontier ()
 {
 	auto this_l (shared_from_this ());
-	connection->channel->socket->async_read (connection->receive_buffer, nano::frontier_req_client::size_frontier, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		// An issue with asio is that sometimes, instead of reporting a bad file descriptor during disconnect,
-		// we simply get a size of 0.
-		if (size_a == nano::frontier_req_client::size_frontier)
-		{
-			this_l->received_frontier (ec, size_a);
-		}
-		else
-		{
-			if (this_l->connection->node->config.logging.network_message_logging ())
-			{
-				this_l->connection->node->logger.try_log (boost::str (boost::format ("Invalid size: expected %1%, got %2%") % nano::frontier_req_client::size_frontier % size_a));
-			}
-		}
+	connection->channel->socket->async_read_some (buffer, buffer_used, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		this_l->received_frontier (ec, size_a);
 	});
 }
 
@@ -141,46 +168,91 @@ void nano::frontier_req_client::unsynced (nano::block_hash const & head, nano::b
 
 void nano::frontier_req_client::received_frontier (boost::system::error_code const & ec, size_t size_a)
 {
-	if (!ec)
+	// An issue with asio is that sometimes, instead of reporting a bad file descriptor during disconnect,
+	// we simply get a size of 0.
+	if (!ec && size_a != 0)
 	{
-		assert (size_a == nano::frontier_req_client::size_frontier);
-		nano::account account;
-		nano::bufferstream account_stream (connection->receive_buffer->data (), sizeof (account));
-		auto error1 (nano::try_read (account_stream, account));
-		(void)error1;
-		assert (!error1);
-		nano::block_hash latest;
-		nano::bufferstream latest_stream (connection->receive_buffer->data () + sizeof (account), sizeof (latest));
-		auto error2 (nano::try_read (latest_stream, latest));
-		(void)error2;
-		assert (!error2);
-		if (count == 0)
+		buffer_used += size_a;
+		auto finished (false);
+		size_t position (0);
+		{
+			auto transaction (connection->node->store.tx_begin_read ());
+			for (; !finished && buffer_used - position >= nano::frontier_req_client::size_frontier; position += nano::frontier_req_client::size_frontier)
+			{
+				nano::account account;
+				nano::block_hash latest;
+				nano::bufferstream stream (buffer->data () + position, nano::frontier_req_client::size_frontier);
+				auto error1 (nano::try_read (stream, account));
+				(void)error1;
+				assert (!error1);
+				auto error2 (nano::try_read (stream, latest));
+				(void)error2;
+				assert (!error2);
+				finished = process_frontier (transaction, account, latest);
+			}
+		}
+		if (!finished)
 		{
-			start_time = std::chrono::steady_clock::now ();
+			flush_pulls (false);
+			// Keep a partially received frontier for the next read
+			std::copy (buffer->begin () + position, buffer->begin () + buffer_used, buffer->begin ());
+			buffer_used -= position;
+			receive_frontier ();
 		}
-		++count;
-		std::chrono::duration<double> time_span = std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - start_time);
-
-		double elapsed_sec = std::max (time_span.count (), bootstrap_minimum_elapsed_seconds_blockrate);
-		double blocks_per_sec = static_cast<double> (count) / elapsed_sec;
-		if (elapsed_sec > bootstrap_connection_warmup_time_sec && blocks_per_sec < bootstrap_minimum_frontier_blocks_per_sec)
+	}
+	else if (ec)
+	{
+		if (connection->node->config.logging.network_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Aborting frontier req because it was too slow")));
-			promise.set_value (true);
-			return;
+			connection->node->logger.try_log (boost::str (boost::format ("Error while receiving frontier %1%") % ec.message ()));
 		}
+	}
+	else if (connection->node->config.logging.network_message_logging ())
+	{
+		connection->node->logger.try_log ("Invalid size: expected frontiers, got 0 bytes");
+	}
+}
+
+bool nano::frontier_req_client::process_frontier (nano::transaction const & transaction_a, nano::account const & account, nano::block_hash const & latest)
+{
+	auto result (false);
+	if (count == 0)
+	{
+		start_time = std::chrono::steady_clock::now ();
+	}
+	++count;
+	std::chrono::duration<double> time_span = std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - start_time);
+
+	double elapsed_sec = std::max (time_span.count (), bootstrap_minimum_elapsed_seconds_blockrate);
+	double blocks_per_sec = static_cast<double> (count) / elapsed_sec;
+	if (elapsed_sec > bootstrap_connection_warmup_time_sec && blocks_per_sec < bootstrap_minimum_frontier_blocks_per_sec)
+	{
+		connection->node->logger.try_log (boost::str (boost::format ("Aborting frontier req because it was too slow")));
+		promise.set_value (true);
+		result = true;
+	}
+	else
+	{
 		if (connection->attempt->should_log ())
 		{
 			connection->node->logger.always_log (boost::str (boost::format ("Received %1% frontiers from %2%") % std::to_string (count) % connection->channel->to_string ()));
 		}
-		auto transaction (connection->node->store.tx_begin_read ());
 		if (!account.is_zero ())
+		{
+			++request_received;
+		}
+		if (!account.is_zero () && !end.is_zero () && !(account < end))
+		{
+			// Past the end of this range, another request covers it
+			passed_end = true;
+		}
+		else if (!account.is_zero ())
 		{
 			while (!current.is_zero () && current < account)
 			{
 				// We know about an account they don't.
 				unsynced (frontier, 0);
-				next (transaction);
+				next (transaction_a);
 			}
 			if (!current.is_zero ())
 			{
@@ -192,45 +264,53 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 					}
 					else
 					{
-						if (connection->node->store.block_exists (transaction, latest))
+						if (connection->node->store.block_exists (transaction_a, latest))
 						{
 							// We know about a block they don't.
 							unsynced (frontier, latest);
 						}
 						else
 						{
-							connection->attempt->add_pull (nano::pull_info (account, latest, frontier));
+							pending_pulls.emplace_back (account, latest, frontier);
 							// Either we're behind or there's a fork we differ on
 							// Either way, bulk pushing will probably not be effective
 							bulk_push_cost += 5;
 						}
 					}
-					next (transaction);
+					next (transaction_a);
 				}
 				else
 				{
 					assert (account < current);
-					connection->attempt->add_pull (nano::pull_info (account, latest, nano::block_hash (0)));
+					pending_pulls.emplace_back (account, latest, nano::block_hash (0));
 				}
 			}
 			else
 			{
-				connection->attempt->add_pull (nano::pull_info (account, latest, nano::block_hash (0)));
+				pending_pulls.emplace_back (account, latest, nano::block_hash (0));
 			}
-			receive_frontier ();
+			cursor = account;
+		}
+		else if (!passed_end && request_received == request_count)
+		{
+			// The chunk ran out before the end of the range, continue after the cursor on the same connection
+			flush_pulls (false);
+			run ();
+			result = true;
 		}
 		else
 		{
-			while (!current.is_zero ())
+			while (!current.is_zero () && (end.is_zero () || current < end))
 			{
 				// We know about an account they don't.
 				unsynced (frontier, 0);
-				next (transaction);
+				next (transaction_a);
 			}
 			if (connection->node->config.logging.bulk_pull_logging ())
 			{
 				connection->node->logger.try_log ("Bulk push cost: ", bulk_push_cost);
 			}
+			flush_pulls (true);
 			{
 				try
 				{
@@ -241,23 +321,24 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 				}
 				connection->attempt->pool_connection (connection);
 			}
+			result = true;
 		}
 	}
-	else
-	{
-		if (connection->node->config.logging.network_logging ())
-		{
-			connection->node->logger.try_log (boost::str (boost::format ("Error while receiving frontier %1%") % ec.message ()));
-		}
-	}
+	return result;
+}
+
+void nano::frontier_req_client::flush_pulls (bool complete_a)
+{
+	connection->attempt->add_pulls (pending_pulls, cursor, end, complete_a);
+	pending_pulls.clear ();
 }
 
 void nano::frontier_req_client::next (nano::transaction const & transaction_a)
 {
-	// Filling accounts deque to prevent often read transactions
+	// Filling accounts deque to prevent often read transactions, one refill covers a full receive buffer of remote frontiers
 	if (accounts.empty ())
 	{
-		size_t max_size (128);
+		size_t max_size (buffer_size / size_frontier);
 		for (auto i (connection->node->store.latest_begin (transaction_a, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
 		{
 			nano::account_info const & info (i->second);
@@ -283,9 +364,16 @@ connection (connection_a),
 known_account (0),
 pull (pull_a),
 pull_blocks (0),
-unexpected_count (0)
+unexpected_count (0),
+invalid_count (0),
+start_time (std::chrono::steady_clock::now ()),
+credits (0)
 {
 	std::lock_guard<std::mutex> mutex (connection->attempt->mutex);
+	if (connection->attempt->mode == nano::bootstrap_mode::legacy)
+	{
+		connection->attempt->pulls_in_flight[pull.account] = pull;
+	}
 	connection->attempt->condition.notify_all ();
 }
 
@@ -310,8 +398,11 @@ nano::bulk_pull_client::~bulk_pull_client ()
 	{
 		connection->node->bootstrap_initiator.cache.remove (pull);
 	}
+	auto valid_blocks (pull_blocks - std::min (pull_blocks, invalid_count));
+	connection->node->bootstrap_initiator.peer_scores.pulled (connection->channel->socket->remote_endpoint (), valid_blocks, invalid_count, std::chrono::steady_clock::now () - start_time, expected == pull.end);
 	{
 		std::lock_guard<std::mutex> mutex (connection->attempt->mutex);
+		connection->attempt->pulls_in_flight.erase (pull.account);
 		--connection->attempt->pulling;
 	}
 	connection->attempt->condition.notify_all ();
@@ -357,14 +448,25 @@ void nano::bulk_pull_client::request ()
 
 void nano::bulk_pull_client::throttled_receive_block ()
 {
-	if (!connection->node->block_processor.half_full ())
+	if (credits == 0)
+	{
+		credits = std::min (connection->node->block_processor.capacity (), bootstrap_pull_credits);
+	}
+	if (credits != 0)
 	{
+		--credits;
 		receive_block ();
 	}
 	else
 	{
+		// Pause reading until the block processor has drained enough to accept more
+		throttle_start = std::chrono::steady_clock::now ();
+		connection->node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull_throttled, nano::stat::dir::in);
 		auto this_l (shared_from_this ());
-		connection->node->alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (1), [this_l]() {
+		connection->node->block_processor.wait_capacity ([this_l]() {
+			auto throttled (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - this_l->throttle_start).count ());
+			this_l->connection->throttled_ms += throttled;
+			this_l->connection->node->stats.add (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull_throttled_ms, nano::stat::dir::in, throttled);
 			if (!this_l->connection->pending_stop && !this_l->connection->attempt->stopped)
 			{
 				this_l->throttled_receive_block ();
@@ -478,6 +580,11 @@ void nano::bulk_pull_client::received_block (boost::system::error_code const & e
 			else
 			{
 				unexpected_count++;
+				if (connection->attempt->mode == nano::bootstrap_mode::legacy)
+				{
+					// Legacy pulls follow a single chain, anything else is not what was asked for
+					invalid_count++;
+				}
 			}
 			if (pull_blocks == 0 && block_expected)
 			{
@@ -512,6 +619,7 @@ void nano::bulk_pull_client::received_block (boost::system::error_code const & e
 		}
 		else
 		{
+			invalid_count++;
 			if (connection->node->config.logging.bulk_pull_logging ())
 			{
 				connection->node->logger.try_log ("Error deserializing block received from pull request");
@@ -646,11 +754,13 @@ void nano::bulk_push_client::push_block (nano::block const & block_a)
 	});
 }
 
-nano::bulk_pull_account_client::bulk_pull_account_client (std::shared_ptr<nano::bootstrap_client> connection_a, nano::account const & account_a) :
+nano::bulk_pull_account_client::bulk_pull_account_client (std::shared_ptr<nano::bootstrap_client> connection_a, std::deque<nano::account> const & accounts_a) :
 connection (connection_a),
-account (account_a),
-pull_blocks (0)
+accounts (accounts_a),
+pull_blocks (0),
+buffer (std::make_shared<std::vector<uint8_t>> (buffer_size))
 {
+	assert (!accounts.empty ());
 	connection->attempt->condition.notify_all ();
 }
 
@@ -665,106 +775,150 @@ nano::bulk_pull_account_client::~bulk_pull_account_client ()
 
 void nano::bulk_pull_account_client::request ()
 {
-	nano::bulk_pull_account req;
-	req.account = account;
-	req.minimum_amount = connection->node->config.receive_minimum;
-	req.flags = nano::bulk_pull_account_flags::pending_hash_and_amount;
+	// Pipeline one request per account in a single write, the server answers them in order on this connection
+	auto buffer_l (std::make_shared<std::vector<uint8_t>> ());
+	{
+		nano::vectorstream stream (*buffer_l);
+		for (auto const & account : accounts)
+		{
+			nano::bulk_pull_account req;
+			req.account = account;
+			req.minimum_amount = connection->node->config.receive_minimum;
+			req.flags = nano::bulk_pull_account_flags::pending_hash_and_amount;
+			req.serialize (stream);
+		}
+	}
 	if (connection->node->config.logging.bulk_pull_logging ())
 	{
 		std::unique_lock<std::mutex> lock (connection->attempt->mutex);
-		connection->node->logger.try_log (boost::str (boost::format ("Requesting pending for account %1% from %2%. %3% accounts in queue") % req.account.to_account () % connection->channel->to_string () % connection->attempt->wallet_accounts.size ()));
+		connection->node->logger.try_log (boost::str (boost::format ("Requesting pending for %1% accounts starting with %2% from %3%. %4% accounts in queue") % accounts.size () % accounts.front ().to_account () % connection->channel->to_string () % connection->attempt->wallet_accounts.size ()));
 	}
 	else if (connection->node->config.logging.network_logging () && connection->attempt->should_log ())
 	{
 		std::unique_lock<std::mutex> lock (connection->attempt->mutex);
 		connection->node->logger.always_log (boost::str (boost::format ("%1% accounts in pull queue") % connection->attempt->wallet_accounts.size ()));
 	}
+	connection->node->stats.add (nano::stat::type::message, nano::stat::detail::bulk_pull_account, nano::stat::dir::out, accounts.size ());
 	auto this_l (shared_from_this ());
-	connection->channel->send (
-	req, [this_l](boost::system::error_code const & ec, size_t size_a) {
+	connection->channel->send_buffer (buffer_l, nano::stat::detail::bulk_pull_account, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		if (!ec)
 		{
 			this_l->receive_pending ();
 		}
 		else
 		{
-			this_l->connection->attempt->requeue_pending (this_l->account);
+			this_l->requeue ();
 			if (this_l->connection->node->config.logging.bulk_pull_logging ())
 			{
 				this_l->connection->node->logger.try_log (boost::str (boost::format ("Error starting bulk pull request to %1%: to %2%") % ec.message () % this_l->connection->channel->to_string ()));
 			}
 			this_l->connection->node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull_error_starting_request, nano::stat::dir::in);
 		}
-	},
-	false); // is bootstrap traffic is_droppable false
+	});
 }
 
 void nano::bulk_pull_account_client::receive_pending ()
 {
 	auto this_l (shared_from_this ());
-	size_t size_l (sizeof (nano::uint256_union) + sizeof (nano::uint128_union));
-	connection->channel->socket->async_read (connection->receive_buffer, size_l, [this_l, size_l](boost::system::error_code const & ec, size_t size_a) {
-		// An issue with asio is that sometimes, instead of reporting a bad file descriptor during disconnect,
-		// we simply get a size of 0.
-		if (size_a == size_l)
+	connection->channel->socket->async_read_some (buffer, buffer_used, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		this_l->received_pending (ec, size_a);
+	});
+}
+
+void nano::bulk_pull_account_client::received_pending (boost::system::error_code const & ec, size_t size_a)
+{
+	// An issue with asio is that sometimes, instead of reporting a bad file descriptor during disconnect,
+	// we simply get a size of 0.
+	if (!ec && size_a != 0)
+	{
+		buffer_used += size_a;
+		auto finished (false);
+		size_t position (0);
 		{
-			if (!ec)
+			auto transaction (connection->node->store.tx_begin_read ());
+			for (; !finished && buffer_used - position >= nano::bulk_pull_account_client::size_pending; position += nano::bulk_pull_account_client::size_pending)
 			{
 				nano::block_hash pending;
-				nano::bufferstream frontier_stream (this_l->connection->receive_buffer->data (), sizeof (nano::uint256_union));
-				auto error1 (nano::try_read (frontier_stream, pending));
+				nano::amount balance;
+				nano::bufferstream stream (buffer->data () + position, nano::bulk_pull_account_client::size_pending);
+				auto error1 (nano::try_read (stream, pending));
 				(void)error1;
 				assert (!error1);
-				nano::amount balance;
-				nano::bufferstream balance_stream (this_l->connection->receive_buffer->data () + sizeof (nano::uint256_union), sizeof (nano::uint128_union));
-				auto error2 (nano::try_read (balance_stream, balance));
+				auto error2 (nano::try_read (stream, balance));
 				(void)error2;
 				assert (!error2);
-				if (this_l->pull_blocks == 0 || !pending.is_zero ())
-				{
-					if (this_l->pull_blocks == 0 || balance.number () >= this_l->connection->node->config.receive_minimum.number ())
-					{
-						this_l->pull_blocks++;
-						{
-							if (!pending.is_zero ())
-							{
-								auto transaction (this_l->connection->node->store.tx_begin_read ());
-								if (!this_l->connection->node->store.block_exists (transaction, pending))
-								{
-									this_l->connection->attempt->lazy_start (pending);
-								}
-							}
-						}
-						this_l->receive_pending ();
-					}
-					else
-					{
-						this_l->connection->attempt->requeue_pending (this_l->account);
-					}
-				}
-				else
-				{
-					this_l->connection->attempt->pool_connection (this_l->connection);
-				}
+				finished = process_pending (transaction, pending, balance);
 			}
-			else
+		}
+		if (!finished)
+		{
+			// Keep a partially received entry for the next read
+			std::copy (buffer->begin () + position, buffer->begin () + buffer_used, buffer->begin ());
+			buffer_used -= position;
+			receive_pending ();
+		}
+		else if (accounts.empty ())
+		{
+			connection->attempt->pool_connection (connection);
+		}
+		else
+		{
+			requeue ();
+		}
+	}
+	else
+	{
+		requeue ();
+		if (ec)
+		{
+			if (connection->node->config.logging.network_logging ())
+			{
+				connection->node->logger.try_log (boost::str (boost::format ("Error while receiving bulk pull account frontier %1%") % ec.message ()));
+			}
+		}
+		else if (connection->node->config.logging.network_message_logging ())
+		{
+			connection->node->logger.try_log ("Invalid size: expected pending entries, got 0 bytes");
+		}
+	}
+}
+
+bool nano::bulk_pull_account_client::process_pending (nano::transaction const & transaction_a, nano::block_hash const & pending, nano::amount const & balance)
+{
+	auto result (false);
+	if (pull_blocks == 0 || !pending.is_zero ())
+	{
+		// The first entry of each response is the account frontier and balance
+		if (pull_blocks == 0 || balance.number () >= connection->node->config.receive_minimum.number ())
+		{
+			pull_blocks++;
+			if (!pending.is_zero ())
 			{
-				this_l->connection->attempt->requeue_pending (this_l->account);
-				if (this_l->connection->node->config.logging.network_logging ())
+				if (!connection->node->store.block_exists (transaction_a, pending))
 				{
-					this_l->connection->node->logger.try_log (boost::str (boost::format ("Error while receiving bulk pull account frontier %1%") % ec.message ()));
+					connection->attempt->lazy_start (pending);
 				}
 			}
 		}
 		else
 		{
-			this_l->connection->attempt->requeue_pending (this_l->account);
-			if (this_l->connection->node->config.logging.network_message_logging ())
-			{
-				this_l->connection->node->logger.try_log (boost::str (boost::format ("Invalid size: expected %1%, got %2%") % size_l % size_a));
-			}
+			result = true;
 		}
-	});
+	}
+	else
+	{
+		// Terminator, move on to the response for the next account
+		accounts.pop_front ();
+		pull_blocks = 0;
+		result = accounts.empty ();
+	}
+	return result;
+}
+
+void nano::bulk_pull_account_client::requeue ()
+{
+	connection->attempt->requeue_pending (accounts);
+	accounts.clear ();
 }
 
 nano::pull_info::pull_info (nano::account const & account_a, nano::block_hash const & head_a, nano::block_hash const & end_a, count_t count_a) :
@@ -786,6 +940,9 @@ total_blocks (0),
 runs_count (0),
 stopped (false),
 mode (mode_a),
+lazy_blocks (static_cast<size_t> (node_a->config.bootstrap_lazy_max_memory) * 1024 * 1024 / 2),
+lazy_state_unknown (static_cast<size_t> (node_a->config.bootstrap_lazy_max_memory) * 1024 * 1024 / 4, bootstrap_lazy_pending_age),
+lazy_balances (static_cast<size_t> (node_a->config.bootstrap_lazy_max_memory) * 1024 * 1024 / 4, bootstrap_lazy_pending_age),
 lazy_stopped (0)
 {
 	node->logger.always_log ("Starting bootstrap attempt");
@@ -813,38 +970,64 @@ bool nano::bootstrap_attempt::should_log ()
 
 bool nano::bootstrap_attempt::request_frontier (std::unique_lock<std::mutex> & lock_a)
 {
-	auto result (true);
-	auto connection_l (connection (lock_a));
-	connection_frontier_request = connection_l;
-	if (connection_l)
+	if (frontier_ranges.empty ())
 	{
-		std::future<bool> future;
+		// Split the account space left after the cursor in to equal ranges, each compared against a different peer
+		auto ranges (std::max (1U, std::min (bootstrap_frontier_ranges_max, node->config.bootstrap_connections)));
+		nano::uint256_t base (frontier_cursor.number ());
+		nano::uint256_t span ((std::numeric_limits<nano::uint256_t>::max () - base) / ranges);
+		if (span == 0)
 		{
-			auto client (std::make_shared<nano::frontier_req_client> (connection_l));
-			client->run ();
-			frontiers = client;
-			future = client->promise.get_future ();
+			ranges = 1;
 		}
-		lock_a.unlock ();
-		result = consume_future (future); // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
-		lock_a.lock ();
-		if (result)
+		for (auto i (0U); i < ranges; ++i)
 		{
-			pulls.clear ();
+			nano::account cursor (i == 0 ? base : base + span * i - 1);
+			nano::account end (i + 1 == ranges ? nano::uint256_t (0) : base + span * (i + 1));
+			frontier_ranges.push_back (nano::frontier_range{ cursor, end, false });
 		}
-		if (node->config.logging.network_logging ())
+	}
+	std::vector<std::future<bool>> futures;
+	frontiers.clear ();
+	for (size_t i (0); i < frontier_ranges.size () && !stopped; ++i)
+	{
+		if (!frontier_ranges[i].complete)
 		{
-			if (!result)
-			{
-				node->logger.try_log (boost::str (boost::format ("Completed frontier request, %1% out of sync accounts according to %2%") % pulls.size () % connection_l->channel->to_string ()));
-			}
-			else
+			// Waits for an idle connection, with fewer connections than ranges the remaining ranges reuse those of finished ones
+			auto connection_l (connection (lock_a));
+			if (connection_l)
 			{
-				node->stats.inc (nano::stat::type::error, nano::stat::detail::frontier_req, nano::stat::dir::out);
+				if (futures.empty ())
+				{
+					connection_frontier_request = connection_l;
+				}
+				auto client (std::make_shared<nano::frontier_req_client> (connection_l, frontier_ranges[i].cursor, frontier_ranges[i].end));
+				client->run ();
+				frontiers.push_back (client);
+				futures.push_back (client->promise.get_future ());
 			}
 		}
 	}
-	return result;
+	lock_a.unlock ();
+	unsigned failures (0);
+	for (auto & future : futures)
+	{
+		if (consume_future (future)) // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
+		{
+			++failures;
+		}
+	}
+	lock_a.lock ();
+	// On failure pulls found so far are kept, the next frontier request resumes each incomplete range after its cursor
+	if (failures != 0)
+	{
+		node->stats.add (nano::stat::type::error, nano::stat::detail::frontier_req, nano::stat::dir::out, failures);
+	}
+	if (node->config.logging.network_logging () && frontiers_complete)
+	{
+		node->logger.try_log (boost::str (boost::format ("Completed frontier request over %1% ranges, %2% out of sync accounts") % frontier_ranges.size () % pulls.size ()));
+	}
+	return !frontiers_complete;
 }
 
 void nano::bootstrap_attempt::request_pull (std::unique_lock<std::mutex> & lock_a)
@@ -852,27 +1035,105 @@ void nano::bootstrap_attempt::request_pull (std::unique_lock<std::mutex> & lock_
 	auto connection_l (connection (lock_a));
 	if (connection_l)
 	{
-		auto pull (pulls.front ());
-		pulls.pop_front ();
-		if (mode != nano::bootstrap_mode::legacy)
+		// Assign a batch sized to spread the queue over all connections, the connection serves it back to back from pool_connection
+		auto batch_size (std::max<size_t> (1, std::min<size_t> (bootstrap_pull_batch_max, pulls.size () / std::max<size_t> (1, clients.size ()))));
+		// Better scoring peers get up to twice the batch, poorer ones half
+		batch_size = std::max<size_t> (1, static_cast<size_t> (batch_size * node->bootstrap_initiator.peer_scores.relative_score (connection_l->channel->socket->remote_endpoint ()) + 0.5));
+		std::deque<nano::pull_info> batch;
+		if (mode == nano::bootstrap_mode::legacy)
+		{
+			auto count (std::min (batch_size, pulls.size ()));
+			batch.assign (pulls.begin (), pulls.begin () + count);
+			pulls.erase (pulls.begin (), pulls.begin () + count);
+		}
+		else
 		{
-			// Check if pull is obsolete (head was processed)
+			// Skip obsolete pulls (head was processed)
 			std::unique_lock<std::mutex> lock (lazy_mutex);
 			auto transaction (node->store.tx_begin_read ());
-			while (!pulls.empty () && !pull.head.is_zero () && (lazy_blocks.find (pull.head) != lazy_blocks.end () || node->store.block_exists (transaction, pull.head)))
+			while (!pulls.empty () && batch.size () < batch_size)
 			{
-				pull = pulls.front ();
+				auto const & pull (pulls.front ());
+				if (pull.head.is_zero () || (!lazy_blocks.contains (pull.head) && !node->store.block_exists (transaction, pull.head)))
+				{
+					batch.push_back (pull);
+				}
 				pulls.pop_front ();
 			}
 		}
-		++pulling;
-		// The bulk_pull_client destructor attempt to requeue_pull which can cause a deadlock if this is the last reference
-		// Dispatch request in an external thread in case it needs to be destroyed
-		node->background ([connection_l, pull]() {
-			auto client (std::make_shared<nano::bulk_pull_client> (connection_l, pull));
-			client->request ();
-		});
+		if (!batch.empty ())
+		{
+			pulling += static_cast<unsigned> (batch.size ());
+			auto pull (batch.front ());
+			batch.pop_front ();
+			{
+				std::lock_guard<std::mutex> lock (connection_l->pulls_mutex);
+				connection_l->pulls.insert (connection_l->pulls.end (), batch.begin (), batch.end ());
+			}
+			dispatch_pull (connection_l, pull);
+		}
+		else
+		{
+			idle.push_back (connection_l);
+		}
+	}
+}
+
+void nano::bootstrap_attempt::dispatch_pull (std::shared_ptr<nano::bootstrap_client> const & connection_a, nano::pull_info const & pull_a)
+{
+	// The bulk_pull_client destructor attempt to requeue_pull which can cause a deadlock if this is the last reference
+	// Dispatch request in an external thread in case it needs to be destroyed
+	auto connection_l (connection_a);
+	node->background ([connection_l, pull_a]() {
+		auto client (std::make_shared<nano::bulk_pull_client> (connection_l, pull_a));
+		client->request ();
+	});
+}
+
+bool nano::bootstrap_attempt::steal_pull (std::shared_ptr<nano::bootstrap_client> const & connection_a, nano::pull_info & pull_a)
+{
+	assert (!mutex.try_lock ());
+	std::shared_ptr<nano::bootstrap_client> busiest;
+	size_t busiest_size (0);
+	for (auto & i : clients)
+	{
+		auto client (i.lock ());
+		if (client != nullptr && client != connection_a)
+		{
+			std::lock_guard<std::mutex> lock (client->pulls_mutex);
+			if (client->pulls.size () > busiest_size)
+			{
+				busiest = client;
+				busiest_size = client->pulls.size ();
+			}
+		}
+	}
+	auto result (false);
+	if (busiest != nullptr)
+	{
+		// Only one thief at a time while the attempt mutex is held, owners lock only their own queue
+		std::lock_guard<std::mutex> busiest_lock (busiest->pulls_mutex);
+		std::lock_guard<std::mutex> lock (connection_a->pulls_mutex);
+		if (!busiest->pulls.empty ())
+		{
+			// Take the back half, the owner keeps working from the front
+			auto count ((busiest->pulls.size () + 1) / 2);
+			connection_a->pulls.insert (connection_a->pulls.end (), busiest->pulls.end () - count, busiest->pulls.end ());
+			busiest->pulls.erase (busiest->pulls.end () - count, busiest->pulls.end ());
+			pull_a = connection_a->pulls.front ();
+			connection_a->pulls.pop_front ();
+			result = true;
+		}
 	}
+	return result;
+}
+
+void nano::bootstrap_attempt::return_pulls (std::deque<nano::pull_info> & pulls_a)
+{
+	assert (!mutex.try_lock ());
+	pulling -= static_cast<unsigned> (pulls_a.size ());
+	pulls.insert (pulls.begin (), pulls_a.begin (), pulls_a.end ());
+	pulls_a.clear ();
 }
 
 void nano::bootstrap_attempt::request_push (std::unique_lock<std::mutex> & lock_a)
@@ -914,8 +1175,10 @@ void nano::bootstrap_attempt::run ()
 {
 	assert (!node->flags.disable_legacy_bootstrap);
 	populate_connections ();
+	resume ();
+	ongoing_checkpoint ();
 	std::unique_lock<std::mutex> lock (mutex);
-	auto frontier_failure (true);
+	auto frontier_failure (!frontiers_complete);
 	while (!stopped && frontier_failure)
 	{
 		frontier_failure = request_frontier (lock);
@@ -953,6 +1216,9 @@ void nano::bootstrap_attempt::run ()
 	if (!stopped)
 	{
 		node->logger.try_log ("Completed pulls");
+		lock.unlock ();
+		clear_checkpoint ();
+		lock.lock ();
 		request_push (lock);
 		runs_count++;
 		// Start wallet lazy bootstrap if required
@@ -976,6 +1242,13 @@ void nano::bootstrap_attempt::run ()
 			node->unchecked_cleanup ();
 		}
 	}
+	else
+	{
+		// Interrupted before all pulls completed, keep the progress for the next attempt
+		lock.unlock ();
+		checkpoint ();
+		lock.lock ();
+	}
 	stopped = true;
 	condition.notify_all ();
 	idle.clear ();
@@ -1113,7 +1386,7 @@ void nano::bootstrap_attempt::populate_connections ()
 		for (auto i = 0u; i < delta; i++)
 		{
 			auto endpoint (node->network.bootstrap_peer ());
-			if (endpoint != nano::tcp_endpoint (boost::asio::ip::address_v6::any (), 0) && endpoints.find (endpoint) == endpoints.end ())
+			if (endpoint != nano::tcp_endpoint (boost::asio::ip::address_v6::any (), 0) && endpoints.find (endpoint) == endpoints.end () && node->bootstrap_initiator.peer_scores.usable (endpoint))
 			{
 				connect_client (endpoint);
 				std::lock_guard<std::mutex> lock (mutex);
@@ -1149,19 +1422,26 @@ void nano::bootstrap_attempt::connect_client (nano::tcp_endpoint const & endpoin
 	++connections;
 	auto socket (std::make_shared<nano::socket> (node));
 	auto this_l (shared_from_this ());
+	auto start_time (std::chrono::steady_clock::now ());
 	socket->async_connect (endpoint_a,
-	[this_l, socket, endpoint_a](boost::system::error_code const & ec) {
+	[this_l, socket, endpoint_a, start_time](boost::system::error_code const & ec) {
 		if (!ec)
 		{
+			this_l->node->bootstrap_initiator.peer_scores.connected (endpoint_a, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start_time));
 			if (this_l->node->config.logging.bulk_pull_logging ())
 			{
 				this_l->node->logger.try_log (boost::str (boost::format ("Connection established to %1%") % endpoint_a));
 			}
 			auto client (std::make_shared<nano::bootstrap_client> (this_l->node, this_l, std::make_shared<nano::transport::channel_tcp> (*this_l->node, socket)));
+			{
+				std::lock_guard<std::mutex> lock (this_l->mutex);
+				this_l->clients.push_back (client);
+			}
 			this_l->pool_connection (client);
 		}
 		else
 		{
+			this_l->node->bootstrap_initiator.peer_scores.connect_failed (endpoint_a);
 			if (this_l->node->config.logging.network_logging ())
 			{
 				switch (ec.value ())
@@ -1184,15 +1464,48 @@ void nano::bootstrap_attempt::connect_client (nano::tcp_endpoint const & endpoin
 
 void nano::bootstrap_attempt::pool_connection (std::shared_ptr<nano::bootstrap_client> client_a)
 {
-	std::lock_guard<std::mutex> lock (mutex);
+	nano::pull_info pull;
+	auto next (false);
 	if (!stopped && !client_a->pending_stop)
 	{
-		// Idle bootstrap client socket
-		client_a->channel->socket->start_timer (node->network_params.node.idle_timeout);
-		// Push into idle deque
-		idle.push_front (client_a);
+		// Continue with the next assigned pull without taking the attempt mutex
+		std::lock_guard<std::mutex> lock (client_a->pulls_mutex);
+		if (!client_a->pulls.empty ())
+		{
+			pull = client_a->pulls.front ();
+			client_a->pulls.pop_front ();
+			next = true;
+		}
+	}
+	if (!next)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!stopped && !client_a->pending_stop)
+		{
+			next = steal_pull (client_a, pull);
+			if (!next)
+			{
+				// Idle bootstrap client socket
+				client_a->channel->socket->start_timer (node->network_params.node.idle_timeout);
+				// Push into idle deque
+				idle.push_front (client_a);
+			}
+		}
+		else
+		{
+			std::deque<nano::pull_info> pulls_l;
+			{
+				std::lock_guard<std::mutex> client_lock (client_a->pulls_mutex);
+				pulls_l.swap (client_a->pulls);
+			}
+			return_pulls (pulls_l);
+		}
+		condition.notify_all ();
+	}
+	if (next)
+	{
+		dispatch_pull (client_a, pull);
 	}
-	condition.notify_all ();
 }
 
 void nano::bootstrap_attempt::stop ()
@@ -1207,14 +1520,17 @@ void nano::bootstrap_attempt::stop ()
 			client->channel->socket->close ();
 		}
 	}
-	if (auto i = frontiers.lock ())
+	for (auto & frontier : frontiers)
 	{
-		try
-		{
-			i->promise.set_value (true);
-		}
-		catch (std::future_error &)
+		if (auto i = frontier.lock ())
 		{
+			try
+			{
+				i->promise.set_value (true);
+			}
+			catch (std::future_error &)
+			{
+			}
 		}
 	}
 	if (auto i = push.lock ())
@@ -1240,10 +1556,165 @@ void nano::bootstrap_attempt::add_pull (nano::pull_info const & pull_a)
 	condition.notify_all ();
 }
 
-void nano::bootstrap_attempt::requeue_pull (nano::pull_info const & pull_a)
+void nano::bootstrap_attempt::add_pulls (std::vector<nano::pull_info> const & pulls_a, nano::account const & cursor_a, nano::account const & end_a, bool complete_a)
 {
-	auto pull (pull_a);
-	if (++pull.attempts < (bootstrap_frontier_retry_limit + (pull.processed / 10000)))
+	std::vector<nano::pull_info> pulls_l (pulls_a);
+	for (auto & pull : pulls_l)
+	{
+		node->bootstrap_initiator.cache.update_pull (pull);
+	}
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		pulls.insert (pulls.end (), pulls_l.begin (), pulls_l.end ());
+		auto range (std::find_if (frontier_ranges.begin (), frontier_ranges.end (), [&end_a](nano::frontier_range const & range_a) { return range_a.end == end_a; }));
+		if (range != frontier_ranges.end ())
+		{
+			range->cursor = cursor_a;
+			range->complete = complete_a;
+		}
+		else
+		{
+			frontier_ranges.push_back (nano::frontier_range{ cursor_a, end_a, complete_a });
+		}
+		// Only the prefix of the account space with every range below it complete can be checkpointed
+		frontiers_complete = true;
+		for (auto const & i : frontier_ranges)
+		{
+			if (frontiers_complete && !i.complete)
+			{
+				frontier_cursor = i.cursor;
+				frontiers_complete = false;
+			}
+		}
+	}
+	condition.notify_all ();
+}
+
+bool nano::bootstrap_attempt::checkpoint ()
+{
+	std::lock_guard<std::mutex> checkpoint_lock (checkpoint_mutex);
+	std::vector<nano::pull_info> pulls_l;
+	nano::account cursor (0);
+	auto active (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		// Only legacy pulls are checkpointed, lazy pulls are rediscovered from the blocks that started them
+		active = mode == nano::bootstrap_mode::legacy && !pulls_complete;
+		if (active)
+		{
+			cursor = frontiers_complete ? nano::account (std::numeric_limits<nano::uint256_t>::max ()) : frontier_cursor;
+			pulls_l.assign (pulls.begin (), pulls.end ());
+			for (auto & i : clients)
+			{
+				if (auto client = i.lock ())
+				{
+					std::lock_guard<std::mutex> pulls_lock (client->pulls_mutex);
+					pulls_l.insert (pulls_l.end (), client->pulls.begin (), client->pulls.end ());
+				}
+			}
+			for (auto const & i : pulls_in_flight)
+			{
+				pulls_l.push_back (i.second);
+			}
+			checkpoint_stored = true;
+		}
+	}
+	if (active)
+	{
+		auto transaction (node->store.tx_begin_write ({ nano::tables::bootstrap, nano::tables::meta }));
+		node->store.bootstrap_pull_clear (transaction);
+		for (auto & pull : pulls_l)
+		{
+			// Progress kept in the pulls cache is folded in to the checkpointed pull
+			node->bootstrap_initiator.cache.update_pull (pull);
+			node->store.bootstrap_pull_put (transaction, pull.account, nano::pull_checkpoint (pull.head, pull.head_original, pull.end, pull.count, pull.processed));
+		}
+		node->store.bootstrap_frontier_put (transaction, cursor);
+	}
+	if (active && node->config.logging.network_logging ())
+	{
+		node->logger.try_log (boost::str (boost::format ("Checkpointed bootstrap with %1% pulls") % pulls_l.size ()));
+	}
+	return active;
+}
+
+void nano::bootstrap_attempt::resume ()
+{
+	std::lock_guard<std::mutex> checkpoint_lock (checkpoint_mutex);
+	std::vector<nano::pull_info> pulls_l;
+	nano::account cursor (0);
+	auto error (false);
+	{
+		auto transaction (node->store.tx_begin_read ());
+		error = node->store.bootstrap_frontier_get (transaction, cursor);
+		if (!error)
+		{
+			for (auto i (node->store.bootstrap_pull_begin (transaction)), n (node->store.bootstrap_pull_end ()); i != n; ++i)
+			{
+				nano::pull_checkpoint const & checkpoint (i->second);
+				nano::pull_info pull (i->first, checkpoint.head, checkpoint.end, checkpoint.count);
+				pull.head_original = checkpoint.head_original;
+				pull.processed = checkpoint.processed;
+				node->bootstrap_initiator.cache.add (pull);
+				pulls_l.push_back (pull);
+			}
+		}
+	}
+	if (!error)
+	{
+		auto complete (cursor == nano::account (std::numeric_limits<nano::uint256_t>::max ()));
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			pulls.insert (pulls.end (), pulls_l.begin (), pulls_l.end ());
+			frontiers_complete = complete;
+			frontier_cursor = complete ? nano::account (0) : cursor;
+			checkpoint_stored = true;
+		}
+		node->logger.try_log (boost::str (boost::format ("Resuming bootstrap with %1% pulls, frontiers %2%") % pulls_l.size () % (complete ? std::string ("complete") : "after " + cursor.to_account ())));
+	}
+}
+
+void nano::bootstrap_attempt::clear_checkpoint ()
+{
+	std::lock_guard<std::mutex> checkpoint_lock (checkpoint_mutex);
+	auto stored (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		pulls_complete = true;
+		stored = checkpoint_stored;
+		checkpoint_stored = false;
+	}
+	if (stored)
+	{
+		auto transaction (node->store.tx_begin_write ({ nano::tables::bootstrap, nano::tables::meta }));
+		node->store.bootstrap_pull_clear (transaction);
+		node->store.bootstrap_frontier_del (transaction);
+	}
+}
+
+void nano::bootstrap_attempt::ongoing_checkpoint ()
+{
+	std::weak_ptr<nano::bootstrap_attempt> this_w (shared_from_this ());
+	node->alarm.add (std::chrono::steady_clock::now () + bootstrap_checkpoint_interval, [this_w]() {
+		if (auto this_l = this_w.lock ())
+		{
+			if (!this_l->stopped)
+			{
+				this_l->node->worker.push_task ([this_l]() {
+					if (this_l->checkpoint ())
+					{
+						this_l->ongoing_checkpoint ();
+					}
+				});
+			}
+		}
+	});
+}
+
+void nano::bootstrap_attempt::requeue_pull (nano::pull_info const & pull_a)
+{
+	auto pull (pull_a);
+	if (++pull.attempts < (bootstrap_frontier_retry_limit + (pull.processed / 10000)))
 	{
 		std::lock_guard<std::mutex> lock (mutex);
 		pulls.push_front (pull);
@@ -1271,6 +1742,134 @@ void nano::bootstrap_attempt::requeue_pull (nano::pull_info const & pull_a)
 	}
 }
 
+nano::lazy_block_filter::lazy_block_filter (size_t max_memory_a)
+{
+	// Largest power of two number of buckets within the ceiling
+	while (max_buckets * 2 * bucket_size * sizeof (uint64_t) <= max_memory_a)
+	{
+		max_buckets *= 2;
+	}
+}
+
+namespace
+{
+uint64_t lazy_fingerprint (nano::block_hash const & hash_a)
+{
+	// Zero marks an empty slot
+	return hash_a.qwords[0] != 0 ? hash_a.qwords[0] : 1;
+}
+}
+
+size_t nano::lazy_block_filter::alternate (size_t bucket_a, uint64_t fingerprint_a) const
+{
+	auto mask (slots.size () / bucket_size - 1);
+	return (bucket_a ^ ((fingerprint_a >> 32) * 0x5bd1e995)) & mask;
+}
+
+bool nano::lazy_block_filter::contains (nano::block_hash const & hash_a) const
+{
+	auto result (false);
+	if (!slots.empty ())
+	{
+		auto fingerprint (lazy_fingerprint (hash_a));
+		size_t first (fingerprint & (slots.size () / bucket_size - 1));
+		auto second (alternate (first, fingerprint));
+		for (size_t i (0); i < bucket_size && !result; ++i)
+		{
+			result = slots[first * bucket_size + i] == fingerprint || slots[second * bucket_size + i] == fingerprint;
+		}
+	}
+	return result;
+}
+
+void nano::lazy_block_filter::insert (nano::block_hash const & hash_a)
+{
+	if (!contains (hash_a))
+	{
+		if (count >= slots.size () * 9 / 10 && slots.size () / bucket_size < max_buckets)
+		{
+			grow ();
+		}
+		if (place (lazy_fingerprint (hash_a)))
+		{
+			++count;
+		}
+		else
+		{
+			++evicted;
+		}
+	}
+}
+
+bool nano::lazy_block_filter::place (uint64_t fingerprint_a)
+{
+	auto result (false);
+	auto fingerprint (fingerprint_a);
+	size_t bucket (fingerprint & (slots.size () / bucket_size - 1));
+	for (unsigned kicks (0); kicks <= max_kicks && !result; ++kicks)
+	{
+		auto other (alternate (bucket, fingerprint));
+		for (size_t i (0); i < bucket_size && !result; ++i)
+		{
+			for (auto candidate : { bucket, other })
+			{
+				auto & slot (slots[candidate * bucket_size + i]);
+				if (!result && slot == 0)
+				{
+					slot = fingerprint;
+					result = true;
+				}
+			}
+		}
+		if (!result)
+		{
+			// Displace a resident to its other bucket, the last one displaced is forgotten if no room is found
+			std::swap (fingerprint, slots[bucket * bucket_size + kicks % bucket_size]);
+			bucket = alternate (bucket, fingerprint);
+		}
+	}
+	return result;
+}
+
+void nano::lazy_block_filter::grow ()
+{
+	auto buckets (slots.size () / bucket_size);
+	auto new_buckets (buckets == 0 ? std::min (initial_buckets, max_buckets) : std::min (buckets * 2, max_buckets));
+	std::vector<uint64_t> old_slots (new_buckets * bucket_size, 0);
+	old_slots.swap (slots);
+	count = 0;
+	for (auto fingerprint : old_slots)
+	{
+		if (fingerprint != 0)
+		{
+			if (place (fingerprint))
+			{
+				++count;
+			}
+			else
+			{
+				++evicted;
+			}
+		}
+	}
+}
+
+void nano::lazy_block_filter::clear ()
+{
+	std::vector<uint64_t> ().swap (slots);
+	count = 0;
+}
+
+size_t nano::lazy_block_filter::size () const
+{
+	return count;
+}
+
+size_t nano::lazy_block_filter::memory () const
+{
+	return slots.size () * sizeof (uint64_t);
+}
+
 void nano::bootstrap_attempt::add_bulk_push_target (nano::block_hash const & head, nano::block_hash const & end)
 {
 	std::lock_guard<std::mutex> lock (mutex);
@@ -1282,7 +1881,7 @@ void nano::bootstrap_attempt::lazy_start (nano::block_hash const & hash_a)
 	std::unique_lock<std::mutex> lock (lazy_mutex);
 	// Add start blocks, limit 1024 (32k with disabled legacy bootstrap)
 	size_t max_keys (node->flags.disable_legacy_bootstrap ? 32 * 1024 : 1024);
-	if (lazy_keys.size () < max_keys && lazy_keys.find (hash_a) == lazy_keys.end () && lazy_blocks.find (hash_a) == lazy_blocks.end ())
+	if (lazy_keys.size () < max_keys && lazy_keys.find (hash_a) == lazy_keys.end () && !lazy_blocks.contains (hash_a))
 	{
 		lazy_keys.insert (hash_a);
 		lazy_pulls.push_back (hash_a);
@@ -1293,7 +1892,7 @@ void nano::bootstrap_attempt::lazy_add (nano::block_hash const & hash_a)
 {
 	// Add only unknown blocks
 	assert (!lazy_mutex.try_lock ());
-	if (lazy_blocks.find (hash_a) == lazy_blocks.end ())
+	if (!lazy_blocks.contains (hash_a))
 	{
 		lazy_pulls.push_back (hash_a);
 	}
@@ -1307,7 +1906,7 @@ void nano::bootstrap_attempt::lazy_pull_flush ()
 	for (auto & pull_start : lazy_pulls)
 	{
 		// Recheck if block was already processed
-		if (lazy_blocks.find (pull_start) == lazy_blocks.end () && !node->store.block_exists (transaction, pull_start))
+		if (!lazy_blocks.contains (pull_start) && !node->store.block_exists (transaction, pull_start))
 		{
 			assert (node->network_params.bootstrap.lazy_max_pull_blocks <= std::numeric_limits<nano::pull_info::count_t>::max ());
 			pulls.push_back (nano::pull_info (pull_start, pull_start, nano::block_hash (0), static_cast<nano::pull_info::count_t> (node->network_params.bootstrap.lazy_max_pull_blocks)));
@@ -1428,7 +2027,7 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 		auto hash (block_a->hash ());
 		std::unique_lock<std::mutex> lock (lazy_mutex);
 		// Processing new blocks
-		if (lazy_blocks.find (hash) == lazy_blocks.end ())
+		if (!lazy_blocks.contains (hash))
 		{
 			// Search block in ledger (old)
 			auto transaction (node->store.tx_begin_read ());
@@ -1459,7 +2058,7 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 						balance = block_l->hashables.balance.number ();
 						nano::block_hash link (block_l->hashables.link);
 						// If link is not epoch link or 0. And if block from link unknown
-						if (!link.is_zero () && link != node->ledger.epoch_link && lazy_blocks.find (link) == lazy_blocks.end () && !node->store.block_exists (transaction, link))
+						if (!link.is_zero () && link != node->ledger.epoch_link && !lazy_blocks.contains (link) && !node->store.block_exists (transaction, link))
 						{
 							nano::block_hash previous (block_l->hashables.previous);
 							// If state block previous is 0 then source block required
@@ -1477,22 +2076,22 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 								}
 							}
 							// Search balance of already processed previous blocks
-							else if (lazy_blocks.find (previous) != lazy_blocks.end ())
+							else if (lazy_blocks.contains (previous))
 							{
 								auto previous_balance (lazy_balances.find (previous));
-								if (previous_balance != lazy_balances.end ())
+								if (previous_balance != nullptr)
 								{
-									if (previous_balance->second <= balance)
+									if (*previous_balance <= balance)
 									{
 										lazy_add (link);
 									}
-									lazy_balances.erase (previous_balance);
+									lazy_balances.erase (previous);
 								}
 							}
 							// Insert in unknown state blocks if previous wasn't already processed
 							else
 							{
-								lazy_state_unknown.insert (std::make_pair (previous, std::make_pair (link, balance)));
+								lazy_state_unknown.insert (previous, std::make_pair (link, balance));
 							}
 						}
 					}
@@ -1501,10 +2100,10 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 				// Adding lazy balances
 				if (pull_blocks == 0)
 				{
-					lazy_balances.insert (std::make_pair (hash, balance));
+					lazy_balances.insert (hash, balance);
 				}
 				// Removing lazy balances
-				if (!block_a->previous ().is_zero () && lazy_balances.find (block_a->previous ()) != lazy_balances.end ())
+				if (!block_a->previous ().is_zero ())
 				{
 					lazy_balances.erase (block_a->previous ());
 				}
@@ -1522,9 +2121,9 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 			}
 			//Search unknown state blocks balances
 			auto find_state (lazy_state_unknown.find (hash));
-			if (find_state != lazy_state_unknown.end ())
+			if (find_state != nullptr)
 			{
-				auto next_block (find_state->second);
+				auto next_block (*find_state);
 				lazy_state_unknown.erase (hash);
 				// Retrieve balance for previous state blocks
 				if (block_a->type () == nano::block_type::state)
@@ -1581,13 +2180,16 @@ void nano::bootstrap_attempt::request_pending (std::unique_lock<std::mutex> & lo
 	auto connection_l (connection (lock_a));
 	if (connection_l)
 	{
-		auto account (wallet_accounts.front ());
-		wallet_accounts.pop_front ();
+		// Assign a batch sized to spread the queue over all connections, the connection pipelines its requests
+		auto batch_size (std::max<size_t> (1, std::min<size_t> (bootstrap_pending_batch_max, wallet_accounts.size () / std::max<size_t> (1, clients.size ()))));
+		auto count (std::min (batch_size, wallet_accounts.size ()));
+		std::deque<nano::account> accounts (wallet_accounts.begin (), wallet_accounts.begin () + count);
+		wallet_accounts.erase (wallet_accounts.begin (), wallet_accounts.begin () + count);
 		++pulling;
 		// The bulk_pull_account_client destructor attempt to requeue_pull which can cause a deadlock if this is the last reference
 		// Dispatch request in an external thread in case it needs to be destroyed
-		node->background ([connection_l, account]() {
-			auto client (std::make_shared<nano::bulk_pull_account_client> (connection_l, account));
+		node->background ([connection_l, accounts]() {
+			auto client (std::make_shared<nano::bulk_pull_account_client> (connection_l, accounts));
 			client->request ();
 		});
 	}
@@ -1603,6 +2205,15 @@ void nano::bootstrap_attempt::requeue_pending (nano::account const & account_a)
 	}
 }
 
+void nano::bootstrap_attempt::requeue_pending (std::deque<nano::account> const & accounts_a)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		wallet_accounts.insert (wallet_accounts.begin (), accounts_a.begin (), accounts_a.end ());
+		condition.notify_all ();
+	}
+}
+
 void nano::bootstrap_attempt::wallet_start (std::deque<nano::account> & accounts_a)
 {
 	std::lock_guard<std::mutex> lock (mutex);
@@ -1830,9 +2441,23 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (bootstrap_initiato
 
 	auto sizeof_element = sizeof (decltype (bootstrap_initiator.observers)::value_type);
 	auto sizeof_cache_element = sizeof (decltype (bootstrap_initiator.cache.cache)::value_type);
+	auto peer_scores_count (bootstrap_initiator.peer_scores.size ());
+	auto sizeof_peer_score_element = sizeof (decltype (bootstrap_initiator.peer_scores.scores)::value_type);
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "observers", count, sizeof_element }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "pulls_cache", cache_count, sizeof_cache_element }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "peer_scores", peer_scores_count, sizeof_peer_score_element }));
+	if (auto attempt = bootstrap_initiator.current_attempt ())
+	{
+		auto lazy_composite = std::make_unique<seq_con_info_composite> ("lazy");
+		std::lock_guard<std::mutex> guard (attempt->lazy_mutex);
+		lazy_composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_blocks", attempt->lazy_blocks.memory () / sizeof (uint64_t), sizeof (uint64_t) }));
+		lazy_composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_state_unknown", attempt->lazy_state_unknown.size (), decltype (attempt->lazy_state_unknown)::entry_memory }));
+		lazy_composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_balances", attempt->lazy_balances.size (), decltype (attempt->lazy_balances)::entry_memory }));
+		lazy_composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_keys", attempt->lazy_keys.size (), sizeof (decltype (attempt->lazy_keys)::value_type) }));
+		lazy_composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_pulls", attempt->lazy_pulls.size (), sizeof (decltype (attempt->lazy_pulls)::value_type) }));
+		composite->add_component (std::move (lazy_composite));
+	}
 	return composite;
 }
 }
@@ -1963,6 +2588,12 @@ node (node_a)
 
 void nano::bootstrap_server::receive ()
 {
+	if (type == nano::bootstrap_server_type::realtime || type == nano::bootstrap_server_type::realtime_response_server)
+	{
+		// Realtime connections never carry bootstrap streams, so they can be read ahead
+		receive_realtime ();
+		return;
+	}
 	// Increase timeout to receive TCP header (idle server socket)
 	socket->set_timeout (node->network_params.node.idle_timeout);
 	auto this_l (shared_from_this ());
@@ -2192,7 +2823,7 @@ void nano::bootstrap_server::receive_publish_action (boost::system::error_code c
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		std::unique_ptr<nano::publish> request (new nano::publish (error, stream, header_a));
+		std::unique_ptr<nano::publish> request (new nano::publish (error, stream, header_a, &node->block_uniquer));
 		if (!error)
 		{
 			if (type == nano::bootstrap_server_type::realtime || type == nano::bootstrap_server_type::realtime_response_server)
@@ -2217,7 +2848,7 @@ void nano::bootstrap_server::receive_confirm_req_action (boost::system::error_co
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		std::unique_ptr<nano::confirm_req> request (new nano::confirm_req (error, stream, header_a));
+		std::unique_ptr<nano::confirm_req> request (new nano::confirm_req (error, stream, header_a, &node->block_uniquer));
 		if (!error)
 		{
 			if (type == nano::bootstrap_server_type::realtime || type == nano::bootstrap_server_type::realtime_response_server)
@@ -2239,7 +2870,7 @@ void nano::bootstrap_server::receive_confirm_ack_action (boost::system::error_co
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		std::unique_ptr<nano::confirm_ack> request (new nano::confirm_ack (error, stream, header_a));
+		std::unique_ptr<nano::confirm_ack> request (new nano::confirm_ack (error, stream, header_a, &node->vote_uniquer));
 		if (!error)
 		{
 			if (type == nano::bootstrap_server_type::realtime || type == nano::bootstrap_server_type::realtime_response_server)
@@ -2277,6 +2908,162 @@ void nano::bootstrap_server::receive_node_id_handshake_action (boost::system::er
 	}
 }
 
+void nano::bootstrap_server::receive_realtime ()
+{
+	if (realtime_buffer == nullptr)
+	{
+		realtime_buffer = std::make_shared<std::vector<uint8_t>> (realtime_buffer_size);
+		// Partial messages are waited on with the idle timeout, there's no separate header read anymore
+		socket->set_timeout (node->network_params.node.idle_timeout);
+	}
+	auto this_l (shared_from_this ());
+	socket->async_read_some (realtime_buffer, realtime_buffer_used, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		if (this_l->remote_endpoint.port () == 0)
+		{
+			this_l->remote_endpoint = this_l->socket->remote_endpoint ();
+		}
+		this_l->receive_realtime_action (ec, size_a);
+	});
+}
+
+void nano::bootstrap_server::receive_realtime_action (boost::system::error_code const & ec, size_t size_a)
+{
+	if (!ec)
+	{
+		realtime_buffer_used += size_a;
+		std::vector<std::unique_ptr<nano::message>> messages;
+		auto error (false);
+		auto incomplete (false);
+		size_t position (0);
+		while (!error && !incomplete && realtime_buffer_used - position >= nano::message_header::size)
+		{
+			nano::bufferstream header_stream (realtime_buffer->data () + position, nano::message_header::size);
+			nano::message_header header (error, header_stream);
+			if (!error)
+			{
+				auto message_size (nano::message_header::size + header.payload_length_bytes ());
+				if (message_size > realtime_buffer->size ())
+				{
+					error = true;
+				}
+				else if (realtime_buffer_used - position < message_size)
+				{
+					incomplete = true;
+				}
+				else
+				{
+					nano::bufferstream stream (realtime_buffer->data () + position + nano::message_header::size, message_size - nano::message_header::size);
+					error = parse_realtime (header, stream, messages);
+					position += message_size;
+				}
+			}
+		}
+		if (!messages.empty ())
+		{
+			dispatch_realtime (std::move (messages));
+		}
+		if (!error)
+		{
+			// Keep the start of a partially received message for the next read
+			std::copy (realtime_buffer->begin () + position, realtime_buffer->begin () + realtime_buffer_used, realtime_buffer->begin ());
+			realtime_buffer_used -= position;
+			receive_realtime ();
+		}
+		else if (node->config.logging.network_message_logging ())
+		{
+			node->logger.try_log (boost::str (boost::format ("Invalid realtime message received from %1%") % remote_endpoint));
+		}
+	}
+	else if (node->config.logging.network_message_logging ())
+	{
+		node->logger.try_log (boost::str (boost::format ("Error receiving realtime messages: %1%") % ec.message ()));
+	}
+}
+
+bool nano::bootstrap_server::parse_realtime (nano::message_header const & header_a, nano::stream & stream_a, std::vector<std::unique_ptr<nano::message>> & messages_a)
+{
+	auto error (false);
+	switch (header_a.type)
+	{
+		case nano::message_type::keepalive:
+		{
+			std::unique_ptr<nano::keepalive> message (new nano::keepalive (error, stream_a, header_a));
+			if (!error)
+			{
+				messages_a.push_back (std::move (message));
+			}
+			break;
+		}
+		case nano::message_type::publish:
+		{
+			std::unique_ptr<nano::publish> message (new nano::publish (error, stream_a, header_a, &node->block_uniquer));
+			if (!error)
+			{
+				messages_a.push_back (std::move (message));
+			}
+			break;
+		}
+		case nano::message_type::confirm_req:
+		{
+			std::unique_ptr<nano::confirm_req> message (new nano::confirm_req (error, stream_a, header_a, &node->block_uniquer));
+			if (!error)
+			{
+				messages_a.push_back (std::move (message));
+			}
+			break;
+		}
+		case nano::message_type::confirm_ack:
+		{
+			std::unique_ptr<nano::confirm_ack> message (new nano::confirm_ack (error, stream_a, header_a, &node->vote_uniquer));
+			if (!error)
+			{
+				messages_a.push_back (std::move (message));
+			}
+			break;
+		}
+		case nano::message_type::node_id_handshake:
+		case nano::message_type::bulk_pull:
+		case nano::message_type::bulk_pull_account:
+		case nano::message_type::bulk_push:
+		case nano::message_type::frontier_req:
+		{
+			// Not accepted on a realtime connection, skipped
+			break;
+		}
+		default:
+		{
+			if (node->config.logging.network_logging ())
+			{
+				node->logger.try_log (boost::str (boost::format ("Received invalid type from realtime connection %1%") % static_cast<uint8_t> (header_a.type)));
+			}
+			error = true;
+			break;
+		}
+	}
+	return error;
+}
+
+void nano::bootstrap_server::dispatch_realtime (std::vector<std::unique_ptr<nano::message>> messages_a)
+{
+	node->stats.inc (nano::stat::type::tcp, nano::stat::detail::tcp_read_batch, nano::stat::dir::in);
+	node->stats.add (nano::stat::type::tcp, nano::stat::detail::tcp_read_message, nano::stat::dir::in, messages_a.size ());
+	auto this_l (shared_from_this ());
+	auto messages_l (std::make_shared<std::vector<std::unique_ptr<nano::message>>> (std::move (messages_a)));
+	node->background ([this_l, messages_l]() {
+		for (auto const & message : *messages_l)
+		{
+			if (message->header.type == nano::message_type::keepalive)
+			{
+				this_l->node->network.tcp_channels.process_keepalive (static_cast<nano::keepalive const &> (*message), this_l->remote_endpoint, this_l->keepalive_first.exchange (false));
+			}
+			else
+			{
+				this_l->node->network.tcp_channels.process_message (*message, this_l->remote_endpoint, this_l->remote_node_id, this_l->socket, this_l->type);
+			}
+		}
+	});
+}
+
 void nano::bootstrap_server::add_request (std::unique_ptr<nano::message> message_a)
 {
 	assert (message_a != nullptr);
@@ -2574,32 +3361,116 @@ void nano::bulk_pull_server::set_current_end ()
 
 void nano::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
-	{
-		{
-			send_buffer->clear ();
-			nano::vectorstream stream (*send_buffer);
-			nano::serialize_block (stream, *block);
-		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
-		}
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
-	}
-	else
-	{
-		send_finished ();
-	}
+	read_window ();
+	write_window ();
 }
 
-std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
+void nano::bulk_pull_server::read_window ()
 {
-	std::shared_ptr<nano::block> result;
+	next_buffer->clear ();
+	size_t count (0);
+	{
+		nano::vectorstream stream (*next_buffer);
+		auto transaction (connection->node->store.tx_begin_read ());
+		while (!next_last && count < connection->node->config.bootstrap_serving_window)
+		{
+			auto block (get_next (transaction));
+			if (block != nullptr)
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+				}
+				nano::serialize_block (stream, *block);
+				++count;
+			}
+			else
+			{
+				nano::write (stream, nano::block_type::not_a_block);
+				next_last = true;
+			}
+		}
+	}
+	bytes_sent += next_buffer->size ();
+}
+
+void nano::bulk_pull_server::write_window ()
+{
+	auto this_l (shared_from_this ());
+	// Loops instead of recursing when writes finish before the next window is read, which would otherwise grow the stack by a frame per window
+	auto write_next (true);
+	while (write_next)
+	{
+		write_next = false;
+		std::swap (send_buffer, next_buffer);
+		auto last (next_last);
+		connection->socket->async_write (send_buffer, [this_l, last](boost::system::error_code const & ec, size_t size_a) {
+			this_l->sent_action (ec, size_a, last);
+		});
+		if (!last)
+		{
+			// Read ahead while the previous window is on the wire
+			read_window ();
+			std::lock_guard<std::mutex> lock (mutex);
+			if (write_idle)
+			{
+				write_idle = false;
+				write_next = true;
+			}
+			else
+			{
+				next_ready = true;
+			}
+		}
+	}
+}
+
+void nano::bulk_pull_server::sent_action (boost::system::error_code const & ec, size_t size_a, bool last_a)
+{
+	if (!ec)
+	{
+		if (last_a)
+		{
+			if (connection->node->config.logging.bulk_pull_logging ())
+			{
+				auto elapsed_ms (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start_time).count ()));
+				connection->node->logger.try_log (boost::str (boost::format ("Bulk sending finished, %1% blocks and %2% bytes in %3% ms (%4% blocks/s)") % sent_count % bytes_sent % elapsed_ms % (sent_count * 1000 / elapsed_ms)));
+			}
+			connection->finish_request ();
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			if (next_ready)
+			{
+				next_ready = false;
+				lock.unlock ();
+				write_window ();
+			}
+			else
+			{
+				write_idle = true;
+			}
+		}
+	}
+	else
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
+		{
+			connection->node->logger.try_log (boost::str (boost::format ("Unable to bulk send blocks: %1%") % ec.message ()));
+		}
+	}
+}
+
+std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
+{
+	auto transaction (connection->node->store.tx_begin_read ());
+	return get_next (transaction);
+}
+
+std::shared_ptr<nano::block> nano::bulk_pull_server::get_next (nano::transaction const & transaction_a)
+{
+	std::shared_ptr<nano::block> result;
 	bool send_current = false, set_current_to_end = false;
 
 	/*
@@ -2638,8 +3509,7 @@ std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 
 	if (send_current)
 	{
-		auto transaction (connection->node->store.tx_begin_read ());
-		result = connection->node->store.block_get (transaction, current);
+		result = connection->node->store.block_get (transaction_a, current);
 		if (result != nullptr && set_current_to_end == false)
 		{
 			auto previous (result->previous ());
@@ -2669,55 +3539,11 @@ std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 	return result;
 }
 
-void nano::bulk_pull_server::sent_action (boost::system::error_code const & ec, size_t size_a)
-{
-	if (!ec)
-	{
-		send_next ();
-	}
-	else
-	{
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			connection->node->logger.try_log (boost::str (boost::format ("Unable to bulk send block: %1%") % ec.message ()));
-		}
-	}
-}
-
-void nano::bulk_pull_server::send_finished ()
-{
-	send_buffer->clear ();
-	send_buffer->push_back (static_cast<uint8_t> (nano::block_type::not_a_block));
-	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.bulk_pull_logging ())
-	{
-		connection->node->logger.try_log ("Bulk sending finished");
-	}
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
-	});
-}
-
-void nano::bulk_pull_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
-{
-	if (!ec)
-	{
-		assert (size_a == 1);
-		connection->finish_request ();
-	}
-	else
-	{
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			connection->node->logger.try_log ("Unable to send not-a-block");
-		}
-	}
-}
-
 nano::bulk_pull_server::bulk_pull_server (std::shared_ptr<nano::bootstrap_server> const & connection_a, std::unique_ptr<nano::bulk_pull> request_a) :
 connection (connection_a),
 request (std::move (request_a)),
-send_buffer (std::make_shared<std::vector<uint8_t>> ())
+send_buffer (std::make_shared<std::vector<uint8_t>> ()),
+next_buffer (std::make_shared<std::vector<uint8_t>> ())
 {
 	set_current_end ();
 }
@@ -2779,110 +3605,131 @@ void nano::bulk_pull_account_server::send_frontier ()
 	 */
 	if (!invalid_request)
 	{
-		auto stream_transaction (connection->node->store.tx_begin_read ());
-
-		// Get account balance and frontier block hash
-		auto account_frontier_hash (connection->node->ledger.latest (stream_transaction, request->account));
-		auto account_frontier_balance_int (connection->node->ledger.account_balance (stream_transaction, request->account));
-		nano::uint128_union account_frontier_balance (account_frontier_balance_int);
-
-		// Write the frontier block hash and balance into a buffer
+		// Write the frontier block hash and balance followed by the first window of pending entries into a buffer
 		send_buffer->clear ();
+		auto finished (false);
 		{
 			nano::vectorstream output_stream (*send_buffer);
+			{
+				auto stream_transaction (connection->node->store.tx_begin_read ());
+
+				// Get account balance and frontier block hash
+				auto account_frontier_hash (connection->node->ledger.latest (stream_transaction, request->account));
+				auto account_frontier_balance_int (connection->node->ledger.account_balance (stream_transaction, request->account));
+				nano::uint128_union account_frontier_balance (account_frontier_balance_int);
 
-			write (output_stream, account_frontier_hash.bytes);
-			write (output_stream, account_frontier_balance.bytes);
+				write (output_stream, account_frontier_hash.bytes);
+				write (output_stream, account_frontier_balance.bytes);
+				frontier_size = send_buffer->size ();
+			}
+			finished = read_window (output_stream);
 		}
 
 		// Send the buffer to the requestor
-		auto this_l (shared_from_this ());
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
+		write_window (finished);
 	}
 }
 
 void nano::bulk_pull_account_server::send_next_block ()
+{
+	send_buffer->clear ();
+	auto finished (false);
+	{
+		nano::vectorstream output_stream (*send_buffer);
+		finished = read_window (output_stream);
+	}
+	write_window (finished);
+}
+
+bool nano::bulk_pull_account_server::read_window (nano::stream & output_stream)
 {
 	/*
-	 * Get the next item from the queue, it is a tuple with the key (which
-	 * contains the account and hash) and data (which contains the amount)
+	 * Get the next items from the queue under a single transaction, each
+	 * is a tuple with the key (which contains the account and hash) and
+	 * data (which contains the amount)
 	 */
-	auto block_data (get_next ());
-	auto block_info_key (block_data.first.get ());
-	auto block_info (block_data.second.get ());
-
-	if (block_info_key != nullptr)
+	auto result (false);
+	size_t count (0);
+	auto stream_transaction (connection->node->store.tx_begin_read ());
+	while (!result && count < connection->node->config.bootstrap_serving_window)
 	{
-		/*
-		 * If we have a new item, emit it to the socket
-		 */
-		send_buffer->clear ();
-
-		if (pending_address_only)
+		auto block_data (get_next (stream_transaction));
+		if (block_data.first != nullptr)
 		{
-			nano::vectorstream output_stream (*send_buffer);
-
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				connection->node->logger.try_log (boost::str (boost::format ("Sending address: %1%") % block_info->source.to_string ()));
-			}
-
-			write (output_stream, block_info->source.bytes);
+			write_pending (output_stream, *block_data.first, *block_data.second);
+			++count;
 		}
 		else
 		{
-			nano::vectorstream output_stream (*send_buffer);
-
 			if (connection->node->config.logging.bulk_pull_logging ())
 			{
-				connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block_info_key->hash.to_string ()));
+				connection->node->logger.try_log (boost::str (boost::format ("Done sending blocks")));
 			}
+			write_finished (output_stream);
+			result = true;
+		}
+	}
+	return result;
+}
 
-			write (output_stream, block_info_key->hash.bytes);
-			write (output_stream, block_info->amount.bytes);
+void nano::bulk_pull_account_server::write_window (bool finished_a)
+{
+	auto this_l (shared_from_this ());
+	connection->socket->async_write (send_buffer, [this_l, finished_a](boost::system::error_code const & ec, size_t size_a) {
+		if (finished_a)
+		{
+			this_l->complete (ec, size_a);
+		}
+		else
+		{
+			this_l->sent_action (ec, size_a);
+		}
+	});
+}
 
-			if (pending_include_address)
-			{
-				/**
-				 ** Write the source address as well, if requested
-				 **/
-				write (output_stream, block_info->source.bytes);
-			}
+void nano::bulk_pull_account_server::write_pending (nano::stream & output_stream, nano::pending_key const & block_info_key, nano::pending_info const & block_info)
+{
+	if (pending_address_only)
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
+		{
+			connection->node->logger.try_log (boost::str (boost::format ("Sending address: %1%") % block_info.source.to_string ()));
 		}
 
-		auto this_l (shared_from_this ());
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
+		write (output_stream, block_info.source.bytes);
 	}
 	else
 	{
-		/*
-		 * Otherwise, finalize the connection
-		 */
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Done sending blocks")));
+			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block_info_key.hash.to_string ()));
 		}
 
-		send_finished ();
+		write (output_stream, block_info_key.hash.bytes);
+		write (output_stream, block_info.amount.bytes);
+
+		if (pending_include_address)
+		{
+			/**
+			 ** Write the source address as well, if requested
+			 **/
+			write (output_stream, block_info.source.bytes);
+		}
 	}
 }
 
 std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info>> nano::bulk_pull_account_server::get_next ()
+{
+	auto stream_transaction (connection->node->store.tx_begin_read ());
+	return get_next (stream_transaction);
+}
+
+std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info>> nano::bulk_pull_account_server::get_next (nano::transaction const & stream_transaction)
 {
 	std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info>> result;
 
 	while (true)
 	{
-		/*
-		 * For each iteration of this loop, establish and then
-		 * destroy a database transaction, to avoid locking the
-		 * database for a prolonged period.
-		 */
-		auto stream_transaction (connection->node->store.tx_begin_read ());
 		auto stream (connection->node->store.pending_begin (stream_transaction, current_key));
 
 		if (stream == nano::store_iterator<nano::pending_key, nano::pending_info> (nullptr))
@@ -2954,6 +3801,8 @@ void nano::bulk_pull_account_server::sent_action (boost::system::error_code cons
 {
 	if (!ec)
 	{
+		// Only the first window starts with the frontier
+		frontier_size = 0;
 		send_next_block ();
 	}
 	else
@@ -2965,7 +3814,7 @@ void nano::bulk_pull_account_server::sent_action (boost::system::error_code cons
 	}
 }
 
-void nano::bulk_pull_account_server::send_finished ()
+void nano::bulk_pull_account_server::write_finished (nano::stream & output_stream)
 {
 	/*
 	 * The "bulk_pull_account" final sequence is a final block of all
@@ -2975,56 +3824,49 @@ void nano::bulk_pull_account_server::send_finished ()
 	 * "pending_include_address" flag is not set) or 640-bits of zeros
 	 * (if that flag is set).
 	 */
-	send_buffer->clear ();
+	nano::uint256_union account_zero (0);
+	nano::uint128_union balance_zero (0);
 
-	{
-		nano::vectorstream output_stream (*send_buffer);
-		nano::uint256_union account_zero (0);
-		nano::uint128_union balance_zero (0);
+	write (output_stream, account_zero.bytes);
 
-		write (output_stream, account_zero.bytes);
-
-		if (!pending_address_only)
+	if (!pending_address_only)
+	{
+		write (output_stream, balance_zero.bytes);
+		if (pending_include_address)
 		{
-			write (output_stream, balance_zero.bytes);
-			if (pending_include_address)
-			{
-				write (output_stream, account_zero.bytes);
-			}
+			write (output_stream, account_zero.bytes);
 		}
 	}
 
-	auto this_l (shared_from_this ());
-
 	if (connection->node->config.logging.bulk_pull_logging ())
 	{
 		connection->node->logger.try_log ("Bulk sending for an account finished");
 	}
-
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->complete (ec, size_a);
-	});
 }
 
 void nano::bulk_pull_account_server::complete (boost::system::error_code const & ec, size_t size_a)
 {
 	if (!ec)
 	{
+		// The final window ends with the terminator, whose size is that of one entry. When it is also the first window it starts with the frontier
+		assert (size_a >= frontier_size);
+		auto entries_size (size_a - frontier_size);
 		if (pending_address_only)
 		{
-			assert (size_a == 32);
+			assert (entries_size >= 32 && entries_size % 32 == 0);
 		}
 		else
 		{
 			if (pending_include_address)
 			{
-				assert (size_a == 80);
+				assert (entries_size >= 80 && entries_size % 80 == 0);
 			}
 			else
 			{
-				assert (size_a == 48);
+				assert (entries_size >= 48 && entries_size % 48 == 0);
 			}
 		}
+		(void)entries_size;
 
 		connection->finish_request ();
 	}
@@ -3191,6 +4033,7 @@ current (request_a->start.number () - 1),
 frontier (0),
 request (std::move (request_a)),
 send_buffer (std::make_shared<std::vector<uint8_t>> ()),
+next_buffer (std::make_shared<std::vector<uint8_t>> ()),
 count (0)
 {
 	next ();
@@ -3198,76 +4041,101 @@ count (0)
 
 void nano::frontier_req_server::send_next ()
 {
-	if (!current.is_zero () && count < request->count)
+	read_window ();
+	write_window ();
+}
+
+void nano::frontier_req_server::read_window ()
+{
+	next_buffer->clear ();
 	{
+		nano::vectorstream stream (*next_buffer);
+		size_t written (0);
+		for (; !current.is_zero () && count < request->count && written < frontiers_per_write; ++written)
 		{
-			send_buffer->clear ();
-			nano::vectorstream stream (*send_buffer);
+			if (connection->node->config.logging.bulk_pull_logging ())
+			{
+				connection->node->logger.try_log (boost::str (boost::format ("Sending frontier for %1% %2%") % current.to_account () % frontier.to_string ()));
+			}
 			write (stream, current.bytes);
 			write (stream, frontier.bytes);
+			++count;
+			next ();
 		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
+		if (current.is_zero () || count >= request->count)
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending frontier for %1% %2%") % current.to_account () % frontier.to_string ()));
+			nano::uint256_union zero (0);
+			write (stream, zero.bytes);
+			write (stream, zero.bytes);
+			next_last = true;
 		}
-		next ();
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
-	}
-	else
-	{
-		send_finished ();
 	}
 }
 
-void nano::frontier_req_server::send_finished ()
+void nano::frontier_req_server::write_window ()
 {
-	{
-		send_buffer->clear ();
-		nano::vectorstream stream (*send_buffer);
-		nano::uint256_union zero (0);
-		write (stream, zero.bytes);
-		write (stream, zero.bytes);
-	}
+	std::swap (send_buffer, next_buffer);
+	auto last (next_last);
 	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.network_logging ())
+	connection->socket->async_write (send_buffer, [this_l, last](boost::system::error_code const & ec, size_t size_a) {
+		this_l->sent_action (ec, size_a, last);
+	});
+	if (!last)
 	{
-		connection->node->logger.try_log ("Frontier sending finished");
+		connection->node->background ([this_l]() {
+			this_l->read_window ();
+			this_l->window_ready ();
+		});
 	}
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
-	});
 }
 
-void nano::frontier_req_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
+void nano::frontier_req_server::window_ready ()
 {
-	if (!ec)
+	std::unique_lock<std::mutex> lock (mutex);
+	if (write_idle)
 	{
-		connection->finish_request ();
+		write_idle = false;
+		lock.unlock ();
+		write_window ();
 	}
 	else
 	{
-		if (connection->node->config.logging.network_logging ())
-		{
-			connection->node->logger.try_log (boost::str (boost::format ("Error sending frontier finish: %1%") % ec.message ()));
-		}
+		next_ready = true;
 	}
 }
 
-void nano::frontier_req_server::sent_action (boost::system::error_code const & ec, size_t size_a)
+void nano::frontier_req_server::sent_action (boost::system::error_code const & ec, size_t size_a, bool last_a)
 {
 	if (!ec)
 	{
-		count++;
-		send_next ();
+		if (last_a)
+		{
+			if (connection->node->config.logging.network_logging ())
+			{
+				connection->node->logger.try_log ("Frontier sending finished");
+			}
+			connection->finish_request ();
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			if (next_ready)
+			{
+				next_ready = false;
+				lock.unlock ();
+				write_window ();
+			}
+			else
+			{
+				write_idle = true;
+			}
+		}
 	}
 	else
 	{
 		if (connection->node->config.logging.network_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Error sending frontier pair: %1%") % ec.message ()));
+			connection->node->logger.try_log (boost::str (boost::format ("Error sending frontiers: %1%") % ec.message ()));
 		}
 	}
 }
@@ -3279,7 +4147,7 @@ void nano::frontier_req_server::next ()
 	{
 		auto now (nano::seconds_since_epoch ());
 		bool skip_old (request->age != std::numeric_limits<decltype (request->age)>::max ());
-		size_t max_size (128);
+		size_t max_size (frontiers_per_write);
 		auto transaction (connection->node->store.tx_begin_read ());
 		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
 		{
@@ -3353,6 +4221,151 @@ void nano::pulls_cache::remove (nano::pull_info const & pull_a)
 	cache.get<account_head_tag> ().erase (head_512);
 }
 
+double nano::bootstrap_peer_score::block_rate () const
+{
+	return static_cast<double> (blocks) / std::max (pull_seconds, 1.0);
+}
+
+double nano::bootstrap_peer_score::failure_rate () const
+{
+	return requests == 0 ? 0.0 : static_cast<double> (failures) / requests;
+}
+
+double nano::bootstrap_peer_score::validity () const
+{
+	auto total (blocks + invalid_blocks);
+	return total == 0 ? 1.0 : static_cast<double> (blocks) / total;
+}
+
+double nano::bootstrap_peer_score::score () const
+{
+	return block_rate () * (1.0 - failure_rate ()) * validity ();
+}
+
+void nano::bootstrap_peer_scores::connected (nano::tcp_endpoint const & endpoint_a, std::chrono::milliseconds latency_a)
+{
+	update (endpoint_a, [latency_a](nano::bootstrap_peer_score & score_a) {
+		score_a.latency = score_a.latency.count () == 0 ? latency_a : (score_a.latency * 7 + latency_a) / 8;
+	});
+}
+
+void nano::bootstrap_peer_scores::connect_failed (nano::tcp_endpoint const & endpoint_a)
+{
+	update (endpoint_a, [](nano::bootstrap_peer_score & score_a) {
+		++score_a.requests;
+		++score_a.failures;
+	});
+}
+
+void nano::bootstrap_peer_scores::pulled (nano::tcp_endpoint const & endpoint_a, uint64_t blocks_a, uint64_t invalid_a, std::chrono::steady_clock::duration elapsed_a, bool success_a)
+{
+	update (endpoint_a, [blocks_a, invalid_a, elapsed_a, success_a](nano::bootstrap_peer_score & score_a) {
+		score_a.blocks += blocks_a;
+		score_a.invalid_blocks += invalid_a;
+		score_a.pull_seconds += std::chrono::duration_cast<std::chrono::duration<double>> (elapsed_a).count ();
+		++score_a.requests;
+		if (!success_a)
+		{
+			++score_a.failures;
+		}
+	});
+}
+
+void nano::bootstrap_peer_scores::update (nano::tcp_endpoint const & endpoint_a, std::function<void(nano::bootstrap_peer_score &)> const & action_a)
+{
+	std::lock_guard<std::mutex> guard (mutex);
+	auto & index (scores.get<endpoint_tag> ());
+	auto existing (index.find (endpoint_a));
+	if (existing == index.end ())
+	{
+		// Forget the peer updated least recently
+		if (scores.size () >= scores_max)
+		{
+			auto oldest (scores.begin ());
+			if (oldest->score () > 0.0)
+			{
+				score_total -= oldest->score ();
+				--scored_count;
+			}
+			scores.erase (oldest);
+		}
+		nano::bootstrap_peer_score score;
+		score.endpoint = endpoint_a;
+		existing = index.insert (score).first;
+	}
+	if (existing->score () > 0.0)
+	{
+		score_total -= existing->score ();
+		--scored_count;
+	}
+	index.modify (existing, [&action_a](nano::bootstrap_peer_score & score_a) {
+		score_a.last_update = std::chrono::steady_clock::now ();
+		action_a (score_a);
+		if (score_a.requests >= requests_window)
+		{
+			score_a.blocks /= 2;
+			score_a.invalid_blocks /= 2;
+			score_a.pull_seconds /= 2;
+			score_a.requests /= 2;
+			score_a.failures /= 2;
+		}
+	});
+	if (existing->score () > 0.0)
+	{
+		score_total += existing->score ();
+		++scored_count;
+	}
+	if (scored_count == 0)
+	{
+		score_total = 0.0;
+	}
+}
+
+bool nano::bootstrap_peer_scores::usable (nano::tcp_endpoint const & endpoint_a)
+{
+	auto result (true);
+	std::lock_guard<std::mutex> guard (mutex);
+	auto existing (scores.get<endpoint_tag> ().find (endpoint_a));
+	if (existing != scores.get<endpoint_tag> ().end ())
+	{
+		// Give failing peers another chance once their history is old
+		result = existing->requests < 8 || existing->failure_rate () <= 0.5 || std::chrono::steady_clock::now () - existing->last_update > std::chrono::minutes (5);
+	}
+	return result;
+}
+
+double nano::bootstrap_peer_scores::relative_score (nano::tcp_endpoint const & endpoint_a)
+{
+	auto result (1.0);
+	std::lock_guard<std::mutex> guard (mutex);
+	auto existing (scores.get<endpoint_tag> ().find (endpoint_a));
+	if (existing != scores.get<endpoint_tag> ().end () && existing->requests != 0 && scored_count != 0)
+	{
+		auto mean (score_total / scored_count);
+		result = std::min (2.0, std::max (0.5, existing->score () / mean));
+	}
+	return result;
+}
+
+std::vector<nano::bootstrap_peer_score> nano::bootstrap_peer_scores::list ()
+{
+	std::vector<nano::bootstrap_peer_score> result;
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		result.assign (scores.begin (), scores.end ());
+	}
+	std::sort (result.begin (), result.end (), [](nano::bootstrap_peer_score const & lhs, nano::bootstrap_peer_score const & rhs) {
+		return lhs.score () > rhs.score ();
+	});
+	return result;
+}
+
+size_t nano::bootstrap_peer_scores::size ()
+{
+	std::lock_guard<std::mutex> guard (mutex);
+	return scores.size ();
+}
+
 namespace nano
 {
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (pulls_cache & pulls_cache, const std::string & name)
@@ -10,9 +10,11 @@
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <future>
 #include <queue>
@@ -56,8 +58,120 @@ enum class bootstrap_mode
 	lazy,
 	wallet_lazy
 };
+/**
+ * Set of block hashes processed by lazy bootstrap, kept as 64 bit fingerprints in a bucketed cuckoo table.
+ * The table doubles up to a memory ceiling, after which an insert may forget an older hash. A forgotten block is only queued again.
+ */
+class lazy_block_filter final
+{
+public:
+	explicit lazy_block_filter (size_t);
+	bool contains (nano::block_hash const &) const;
+	void insert (nano::block_hash const &);
+	void clear ();
+	size_t size () const;
+	/** Bytes allocated for the table */
+	size_t memory () const;
+	uint64_t evicted{ 0 };
+	static size_t constexpr bucket_size = 4;
+
+private:
+	bool place (uint64_t);
+	void grow ();
+	size_t alternate (size_t, uint64_t) const;
+	std::vector<uint64_t> slots;
+	size_t count{ 0 };
+	size_t max_buckets{ 1 };
+	static size_t constexpr initial_buckets = 256;
+	static unsigned constexpr max_kicks = 128;
+};
+/** Lazy bootstrap state waiting on another block, bounded by memory and age with the oldest entries dropped first */
+template <typename T>
+class lazy_expiring_map final
+{
+public:
+	class entry final
+	{
+	public:
+		nano::block_hash hash;
+		T value;
+		std::chrono::steady_clock::time_point time;
+	};
+	lazy_expiring_map (size_t max_memory_a, std::chrono::steady_clock::duration max_age_a) :
+	max_size (std::max<size_t> (1, max_memory_a / entry_memory)),
+	max_age (max_age_a)
+	{
+	}
+	/** Inserts unless \p hash_a is already present */
+	void insert (nano::block_hash const & hash_a, T const & value_a)
+	{
+		expire ();
+		if (entries.template get<1> ().find (hash_a) == entries.template get<1> ().end ())
+		{
+			if (entries.size () >= max_size)
+			{
+				entries.pop_front ();
+				++evicted;
+			}
+			entries.push_back (entry{ hash_a, value_a, std::chrono::steady_clock::now () });
+		}
+	}
+	T const * find (nano::block_hash const & hash_a) const
+	{
+		auto existing (entries.template get<1> ().find (hash_a));
+		return existing != entries.template get<1> ().end () ? &existing->value : nullptr;
+	}
+	void erase (nano::block_hash const & hash_a)
+	{
+		entries.template get<1> ().erase (hash_a);
+	}
+	void clear ()
+	{
+		entries.clear ();
+	}
+	size_t size () const
+	{
+		return entries.size ();
+	}
+	/** Approximate bytes used including container overhead */
+	size_t memory () const
+	{
+		return entries.size () * entry_memory;
+	}
+	static size_t constexpr entry_memory = sizeof (entry) + 4 * sizeof (void *);
+	uint64_t evicted{ 0 };
+
+private:
+	void expire ()
+	{
+		auto cutoff (std::chrono::steady_clock::now () - max_age);
+		while (!entries.empty () && entries.front ().time < cutoff)
+		{
+			entries.pop_front ();
+			++evicted;
+		}
+	}
+	size_t const max_size;
+	std::chrono::steady_clock::duration const max_age;
+	boost::multi_index_container<
+	entry,
+	boost::multi_index::indexed_by<
+	boost::multi_index::sequenced<>,
+	boost::multi_index::hashed_unique<boost::multi_index::member<entry, nano::block_hash, &entry::hash>>>>
+	entries;
+};
 class frontier_req_client;
 class bulk_push_client;
+/** Slice of the account space whose remote frontiers are compared by one frontier request */
+class frontier_range final
+{
+public:
+	/** Remote frontiers up to this account have been compared */
+	nano::account cursor;
+	/** Exclusive upper bound, zero for the end of the account space */
+	nano::account end;
+	bool complete;
+};
 class bulk_pull_account_client;
 class bootstrap_attempt final : public std::enable_shared_from_this<bootstrap_attempt>
 {
@@ -70,6 +184,11 @@ public:
 	void populate_connections ();
 	bool request_frontier (std::unique_lock<std::mutex> &);
 	void request_pull (std::unique_lock<std::mutex> &);
+	void dispatch_pull (std::shared_ptr<nano::bootstrap_client> const &, nano::pull_info const &);
+	/** Moves the back half of the longest connection pull queue to \p connection_a and returns its first pull in \p pull_a, false if there is nothing to steal */
+	bool steal_pull (std::shared_ptr<nano::bootstrap_client> const &, nano::pull_info &);
+	/** Puts pulls assigned to a connection back at the front of the shared queue */
+	void return_pulls (std::deque<nano::pull_info> &);
 	void request_push (std::unique_lock<std::mutex> &);
 	void add_connection (nano::endpoint const &);
 	void connect_client (nano::tcp_endpoint const &);
@@ -77,6 +196,14 @@ public:
 	void stop ();
 	void requeue_pull (nano::pull_info const &);
 	void add_pull (nano::pull_info const &);
+	/** Queues pulls found comparing remote frontiers of the range ending at \p end_a up to \p cursor_a, \p complete_a once the range has been compared */
+	void add_pulls (std::vector<nano::pull_info> const &, nano::account const & cursor_a, nano::account const & end_a, bool complete_a);
+	/** Writes the frontier cursor and every outstanding pull to the store so a restarted node resumes this attempt, returns false once there is nothing left to checkpoint */
+	bool checkpoint ();
+	/** Restores the frontier cursor and pulls of an interrupted attempt from the store */
+	void resume ();
+	void clear_checkpoint ();
+	void ongoing_checkpoint ();
 	bool still_pulling ();
 	unsigned target_connections (size_t pulls_remaining);
 	bool should_log ();
@@ -90,15 +217,27 @@ public:
 	void lazy_clear ();
 	void request_pending (std::unique_lock<std::mutex> &);
 	void requeue_pending (nano::account const &);
+	void requeue_pending (std::deque<nano::account> const &);
 	void wallet_run ();
 	void wallet_start (std::deque<nano::account> &);
 	bool wallet_finished ();
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<std::weak_ptr<nano::bootstrap_client>> clients;
 	std::weak_ptr<nano::bootstrap_client> connection_frontier_request;
-	std::weak_ptr<nano::frontier_req_client> frontiers;
+	std::vector<std::weak_ptr<nano::frontier_req_client>> frontiers;
 	std::weak_ptr<nano::bulk_push_client> push;
 	std::deque<nano::pull_info> pulls;
+	/** Legacy pulls currently being served, by account */
+	std::unordered_map<nano::account, nano::pull_info> pulls_in_flight;
+	/** Ranges requested in parallel from different peers, created from frontier_cursor by the first frontier request */
+	std::vector<nano::frontier_range> frontier_ranges;
+	/** Remote frontiers up to this account have been compared in every range */
+	nano::account frontier_cursor{ 0 };
+	bool frontiers_complete{ false };
+	bool pulls_complete{ false };
+	bool checkpoint_stored{ false };
+	/** Serializes checkpoint writes, acquired before mutex */
+	std::mutex checkpoint_mutex;
 	std::deque<std::shared_ptr<nano::bootstrap_client>> idle;
 	std::atomic<unsigned> connections;
 	std::atomic<unsigned> pulling;
@@ -112,9 +251,9 @@ public:
 	std::mutex mutex;
 	std::condition_variable condition;
 	// Lazy bootstrap
-	std::unordered_set<nano::block_hash> lazy_blocks;
-	std::unordered_map<nano::block_hash, std::pair<nano::block_hash, nano::uint128_t>> lazy_state_unknown;
-	std::unordered_map<nano::block_hash, nano::uint128_t> lazy_balances;
+	nano::lazy_block_filter lazy_blocks;
+	nano::lazy_expiring_map<std::pair<nano::block_hash, nano::uint128_t>> lazy_state_unknown;
+	nano::lazy_expiring_map<nano::uint128_t> lazy_balances;
 	std::unordered_set<nano::block_hash> lazy_keys;
 	std::deque<nano::block_hash> lazy_pulls;
 	std::atomic<uint64_t> lazy_stopped;
@@ -126,14 +265,22 @@ public:
 class frontier_req_client final : public std::enable_shared_from_this<nano::frontier_req_client>
 {
 public:
-	explicit frontier_req_client (std::shared_ptr<nano::bootstrap_client>);
+	/** Requests remote frontiers starting after \p cursor_a and before \p end_a, up to the end of the account space if it is zero */
+	frontier_req_client (std::shared_ptr<nano::bootstrap_client>, nano::account const & cursor_a, nano::account const & end_a = nano::account (0));
 	~frontier_req_client ();
 	void run ();
+	/** Reads as many frontiers as are available in to buffer */
 	void receive_frontier ();
 	void received_frontier (boost::system::error_code const &, size_t);
+	/** Compares one received frontier with the local ledger, returns true once the frontier stream is complete or aborted */
+	bool process_frontier (nano::transaction const &, nano::account const &, nano::block_hash const &);
 	void unsynced (nano::block_hash const &, nano::block_hash const &);
 	void next (nano::transaction const &);
+	/** Hands the pulls found while processing a read to the attempt under a single lock, along with the cursor they cover */
+	void flush_pulls (bool);
 	std::shared_ptr<nano::bootstrap_client> connection;
+	std::shared_ptr<std::vector<uint8_t>> buffer;
+	size_t buffer_used{ 0 };
 	nano::account current;
 	nano::block_hash frontier;
 	unsigned count;
@@ -144,7 +291,16 @@ public:
 	/** A very rough estimate of the cost of `bulk_push`ing missing blocks */
 	uint64_t bulk_push_cost;
 	std::deque<std::pair<nano::account, nano::block_hash>> accounts;
+	std::vector<nano::pull_info> pending_pulls;
+	/** Last remote frontier whose pulls are in pending_pulls */
+	nano::account cursor;
+	nano::account end;
+	/** Frontiers asked for and received in the current request, the range continues with a new request when they are equal */
+	uint32_t request_count{ 0 };
+	uint32_t request_received{ 0 };
+	bool passed_end{ false };
 	static size_t constexpr size_frontier = sizeof (nano::account) + sizeof (nano::block_hash);
+	static size_t constexpr buffer_size = 1024 * size_frontier;
 };
 class bulk_pull_client final : public std::enable_shared_from_this<nano::bulk_pull_client>
 {
@@ -163,6 +319,11 @@ public:
 	nano::pull_info pull;
 	uint64_t pull_blocks;
 	uint64_t unexpected_count;
+	uint64_t invalid_count;
+	std::chrono::steady_clock::time_point start_time;
+	/** Blocks that may be read before asking the block processor for more capacity */
+	size_t credits;
+	std::chrono::steady_clock::time_point throttle_start;
 };
 class bootstrap_client final : public std::enable_shared_from_this<bootstrap_client>
 {
@@ -181,6 +342,11 @@ public:
 	std::atomic<uint64_t> block_count;
 	std::atomic<bool> pending_stop;
 	std::atomic<bool> hard_stop;
+	/** Total time reads were paused waiting for block processor capacity */
+	std::atomic<uint64_t> throttled_ms;
+	/** Pulls assigned to this connection, served back to back and stolen from by idle connections */
+	std::deque<nano::pull_info> pulls;
+	std::mutex pulls_mutex;
 };
 class bulk_push_client final : public std::enable_shared_from_this<nano::bulk_push_client>
 {
@@ -198,13 +364,24 @@ public:
 class bulk_pull_account_client final : public std::enable_shared_from_this<nano::bulk_pull_account_client>
 {
 public:
-	bulk_pull_account_client (std::shared_ptr<nano::bootstrap_client>, nano::account const &);
+	/** Requests pending entries for each of \p accounts_a back to back over one connection */
+	bulk_pull_account_client (std::shared_ptr<nano::bootstrap_client>, std::deque<nano::account> const &);
 	~bulk_pull_account_client ();
 	void request ();
+	/** Reads as many pending entries as are available in to buffer */
 	void receive_pending ();
+	void received_pending (boost::system::error_code const &, size_t);
+	/** Handles one entry of the response for the front account, returns true once the exchange is complete or aborted */
+	bool process_pending (nano::transaction const &, nano::block_hash const &, nano::amount const &);
+	/** Puts every account not yet fully served back in to the wallet queue */
+	void requeue ();
 	std::shared_ptr<nano::bootstrap_client> connection;
-	nano::account account;
+	std::deque<nano::account> accounts;
 	uint64_t pull_blocks;
+	std::shared_ptr<std::vector<uint8_t>> buffer;
+	size_t buffer_used{ 0 };
+	static size_t constexpr size_pending = sizeof (nano::uint256_union) + sizeof (nano::uint128_union);
+	static size_t constexpr buffer_size = 1024 * size_pending;
 };
 class cached_pulls final
 {
@@ -231,6 +408,59 @@ public:
 	cache;
 	constexpr static size_t cache_size_max = 10000;
 };
+class bootstrap_peer_score final
+{
+public:
+	double block_rate () const;
+	double failure_rate () const;
+	/** Share of served blocks that were well formed and on the requested chain */
+	double validity () const;
+	/** Useful blocks per second, used to rank peers */
+	double score () const;
+	nano::tcp_endpoint endpoint;
+	std::chrono::steady_clock::time_point last_update;
+	uint64_t blocks{ 0 };
+	uint64_t invalid_blocks{ 0 };
+	double pull_seconds{ 0.0 };
+	uint64_t requests{ 0 };
+	uint64_t failures{ 0 };
+	/** Moving average of the time taken to establish a connection */
+	std::chrono::milliseconds latency{ 0 };
+};
+/** Bootstrap history per peer, kept by the initiator across attempts to size batches and skip failing peers */
+class bootstrap_peer_scores final
+{
+public:
+	void connected (nano::tcp_endpoint const &, std::chrono::milliseconds);
+	void connect_failed (nano::tcp_endpoint const &);
+	void pulled (nano::tcp_endpoint const &, uint64_t, uint64_t, std::chrono::steady_clock::duration, bool);
+	/** False for peers that recently failed most of their requests */
+	bool usable (nano::tcp_endpoint const &);
+	/** Score relative to the mean of all known peers, clamped to [0.5, 2], 1 for unknown peers */
+	double relative_score (nano::tcp_endpoint const &);
+	/** Known peers ordered by descending score */
+	std::vector<nano::bootstrap_peer_score> list ();
+	size_t size ();
+	std::mutex mutex;
+	class endpoint_tag
+	{
+	};
+	boost::multi_index_container<
+	nano::bootstrap_peer_score,
+	boost::multi_index::indexed_by<
+	boost::multi_index::ordered_non_unique<boost::multi_index::member<nano::bootstrap_peer_score, std::chrono::steady_clock::time_point, &nano::bootstrap_peer_score::last_update>>,
+	boost::multi_index::hashed_unique<boost::multi_index::tag<endpoint_tag>, boost::multi_index::member<nano::bootstrap_peer_score, nano::tcp_endpoint, &nano::bootstrap_peer_score::endpoint>>>>
+	scores;
+	constexpr static size_t scores_max = 4096;
+	/** Counters are halved once a peer reaches this many requests so recent behaviour dominates */
+	constexpr static uint64_t requests_window = 256;
+
+private:
+	void update (nano::tcp_endpoint const &, std::function<void(nano::bootstrap_peer_score &)> const &);
+	/** Sum and count of the positive scores, for the mean used by relative_score */
+	double score_total{ 0.0 };
+	size_t scored_count{ 0 };
+};
 
 class bootstrap_initiator final
 {
@@ -247,6 +477,7 @@ public:
 	bool in_progress ();
 	std::shared_ptr<nano::bootstrap_attempt> current_attempt ();
 	nano::pulls_cache cache;
+	nano::bootstrap_peer_scores peer_scores;
 	void stop ();
 
 private:
@@ -313,6 +544,12 @@ public:
 	void receive_confirm_req_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_confirm_ack_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_node_id_handshake_action (boost::system::error_code const &, size_t, nano::message_header const &);
+	/** Reads realtime traffic in large chunks and dispatches every complete message from each read as one batch */
+	void receive_realtime ();
+	void receive_realtime_action (boost::system::error_code const &, size_t);
+	/** Deserializes a realtime message body and appends it to the batch if it's for this connection, returns true on error */
+	bool parse_realtime (nano::message_header const &, nano::stream &, std::vector<std::unique_ptr<nano::message>> &);
+	void dispatch_realtime (std::vector<std::unique_ptr<nano::message>>);
 	void add_request (std::unique_ptr<nano::message>);
 	void finish_request ();
 	void finish_request_async ();
@@ -320,6 +557,10 @@ public:
 	void timeout ();
 	bool is_bootstrap_connection ();
 	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
+	/** Allocated once the connection turns realtime, holds unparsed bytes at the front */
+	std::shared_ptr<std::vector<uint8_t>> realtime_buffer;
+	size_t realtime_buffer_used{ 0 };
+	static size_t constexpr realtime_buffer_size = 64 * 1024;
 	std::shared_ptr<nano::socket> socket;
 	std::shared_ptr<nano::node> node;
 	std::mutex mutex;
@@ -338,17 +579,28 @@ public:
 	bulk_pull_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::bulk_pull>);
 	void set_current_end ();
 	std::shared_ptr<nano::block> get_next ();
+	std::shared_ptr<nano::block> get_next (nano::transaction const &);
 	void send_next ();
-	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
-	void no_block_sent (boost::system::error_code const &, size_t);
+	/** Serializes the next window of blocks in to next_buffer under one read transaction, ending it with not_a_block once done */
+	void read_window ();
+	/** Writes next_buffer and reads the following window while that write is in flight */
+	void write_window ();
+	void sent_action (boost::system::error_code const &, size_t, bool);
 	std::shared_ptr<nano::bootstrap_server> connection;
 	std::unique_ptr<nano::bulk_pull> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
+	std::shared_ptr<std::vector<uint8_t>> next_buffer;
+	bool next_last{ false };
+	std::mutex mutex;
+	/** Set when next_buffer is complete, or when the previous write finished before it was */
+	bool next_ready{ false };
+	bool write_idle{ false };
 	nano::block_hash current;
 	bool include_start;
 	nano::bulk_pull::count_t max_count;
 	nano::bulk_pull::count_t sent_count;
+	std::chrono::steady_clock::time_point start_time{ std::chrono::steady_clock::now () };
+	uint64_t bytes_sent{ 0 };
 };
 class bulk_pull_account;
 class bulk_pull_account_server final : public std::enable_shared_from_this<nano::bulk_pull_account_server>
@@ -357,16 +609,23 @@ public:
 	bulk_pull_account_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::bulk_pull_account>);
 	void set_params ();
 	std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info>> get_next ();
+	std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info>> get_next (nano::transaction const &);
 	void send_frontier ();
 	void send_next_block ();
+	/** Serializes up to a serving window of pending entries, followed by the terminator once the account is exhausted. Returns true if the terminator was written */
+	bool read_window (nano::stream &);
+	void write_window (bool);
+	void write_pending (nano::stream &, nano::pending_key const &, nano::pending_info const &);
+	void write_finished (nano::stream &);
 	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
 	void complete (boost::system::error_code const &, size_t);
 	std::shared_ptr<nano::bootstrap_server> connection;
 	std::unique_ptr<nano::bulk_pull_account> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
 	std::unordered_set<nano::uint256_union> deduplication;
 	nano::pending_key current_key;
+	/** Bytes of the frontier at the start of the window being written, zero after the first window */
+	size_t frontier_size{ 0 };
 	bool pending_address_only;
 	bool pending_include_address;
 	bool invalid_request;
@@ -388,16 +647,26 @@ class frontier_req_server final : public std::enable_shared_from_this<nano::fron
 public:
 	frontier_req_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::frontier_req>);
 	void send_next ();
-	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
-	void no_block_sent (boost::system::error_code const &, size_t);
+	/** Serializes up to frontiers_per_write frontiers in to next_buffer, ending it with a zero pair once done */
+	void read_window ();
+	/** Writes next_buffer and reads the following window on a background thread while that write is in flight */
+	void write_window ();
+	void window_ready ();
+	void sent_action (boost::system::error_code const &, size_t, bool);
 	void next ();
 	std::shared_ptr<nano::bootstrap_server> connection;
 	nano::account current;
 	nano::block_hash frontier;
 	std::unique_ptr<nano::frontier_req> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
+	std::shared_ptr<std::vector<uint8_t>> next_buffer;
+	bool next_last{ false };
+	std::mutex mutex;
+	/** Set when next_buffer is complete, or when the previous write finished before it was */
+	bool next_ready{ false };
+	bool write_idle{ false };
 	size_t count;
 	std::deque<std::pair<nano::account, nano::block_hash>> accounts;
+	static size_t constexpr frontiers_per_write = 1024;
 };
 }
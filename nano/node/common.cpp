@@ -686,12 +686,8 @@ size_t nano::confirm_req::size (nano::block_type type_a, size_t count)
 
 nano::confirm_ack::confirm_ack (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a, nano::vote_uniquer * uniquer_a) :
 message (header_a),
-vote (nano::make_shared<nano::vote> (error_a, stream_a, header.block_type ()))
+vote (uniquer_a != nullptr ? uniquer_a->deserialize (error_a, stream_a, header.block_type ()) : nano::make_shared<nano::vote> (error_a, stream_a, header.block_type ()))
 {
-	if (!error_a && uniquer_a)
-	{
-		vote = uniquer_a->unique (vote);
-	}
 }
 
 nano::confirm_ack::confirm_ack (std::shared_ptr<nano::vote> vote_a) :
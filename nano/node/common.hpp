@@ -221,6 +221,8 @@ public:
 
 	/** Size of the payload in bytes. For some messages, the payload size is based on header flags. */
 	size_t payload_length_bytes () const;
+	/** Size of the serialized header in bytes */
+	static size_t constexpr size = 8;
 
 	static std::bitset<16> constexpr block_type_mask = std::bitset<16> (0x0f00);
 	static std::bitset<16> constexpr count_mask = std::bitset<16> (0xf000);
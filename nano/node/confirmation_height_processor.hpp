@@ -13,6 +13,7 @@ namespace nano
 class block_store;
 class stat;
 class active_transactions;
+class block_arrival;
 class read_transaction;
 class logger_mt;
 class write_database_queue;
@@ -38,7 +39,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (pending_confirmati
 class confirmation_height_processor final
 {
 public:
-	confirmation_height_processor (pending_confirmation_height &, nano::block_store &, nano::stat &, nano::active_transactions &, nano::block_hash const &, nano::write_database_queue &, std::chrono::milliseconds, nano::logger_mt &);
+	confirmation_height_processor (pending_confirmation_height &, nano::block_store &, nano::stat &, nano::active_transactions &, nano::block_arrival &, nano::block_hash const &, nano::write_database_queue &, std::chrono::milliseconds, nano::logger_mt &);
 	~confirmation_height_processor ();
 	void add (nano::block_hash const &);
 	void stop ();
@@ -84,6 +85,7 @@ private:
 	nano::block_store & store;
 	nano::stat & stats;
 	nano::active_transactions & active;
+	nano::block_arrival & block_arrival;
 	nano::block_hash const & epoch_link;
 	nano::logger_mt & logger;
 	std::atomic<uint64_t> receive_source_pairs_size{ 0 };
@@ -1,6 +1,12 @@
 #include <nano/node/election.hpp>
 #include <nano/node/node.hpp>
 
+namespace
+{
+/** Minimum time between full tally recomputes, weights change with every processed block on a busy node */
+constexpr std::chrono::seconds election_tally_recompute_interval (1);
+}
+
 nano::election_vote_result::election_vote_result (bool replay_a, bool processed_a)
 {
 	replay = replay_a;
@@ -12,11 +18,15 @@ confirmation_action (confirmation_action_a),
 node (node_a),
 election_start (std::chrono::steady_clock::now ()),
 status ({ block_a, 0, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ()), std::chrono::duration_values<std::chrono::milliseconds>::zero (), nano::election_status_type::ongoing }),
+winner_hash (block_a->hash ()),
 confirmed (false),
 stopped (false),
+tally_generation (node_a.ledger.rep_weights.generation ()),
+tally_recomputed (std::chrono::steady_clock::now ()),
 confirmation_request_count (0)
 {
 	last_votes.insert (std::make_pair (node.network_params.random.not_an_account, nano::vote_info{ std::chrono::steady_clock::now (), 0, block_a->hash () }));
+	last_tally[block_a->hash ()] = 0;
 	blocks.insert (std::make_pair (block_a->hash (), block_a));
 	update_dependent ();
 }
@@ -39,6 +49,7 @@ void nano::election::confirm_once (nano::election_status_type type_a)
 		status.election_end = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ());
 		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - election_start);
 		status.type = type_a;
+		node.block_arrival.trace (status.winner->hash (), nano::block_stage::confirmed);
 		auto status_l (status);
 		auto node_l (node.shared ());
 		auto confirmation_action_l (confirmation_action);
@@ -62,6 +73,10 @@ void nano::election::stop ()
 {
 	if (!stopped && !confirmed)
 	{
+		if (confirmation_request_count > node.active.high_confirmation_request_count)
+		{
+			--node.active.long_unconfirmed_size;
+		}
 		stopped = true;
 		status.election_end = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ());
 		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - election_start);
@@ -83,16 +98,19 @@ bool nano::election::have_quorum (nano::tally_t const & tally_a, nano::uint128_t
 	return result;
 }
 
-nano::tally_t nano::election::tally (nano::transaction const & transaction_a)
+void nano::election::tally_refresh (nano::transaction const & transaction_a)
 {
-	std::unordered_map<nano::block_hash, nano::uint128_t> block_weights;
-	for (auto vote_info : last_votes)
+	if (tally_generation != node.ledger.rep_weights.generation () && tally_recomputed + election_tally_recompute_interval <= std::chrono::steady_clock::now ())
 	{
-		block_weights[vote_info.second.hash] += node.ledger.weight (transaction_a, vote_info.first);
+		tally_recompute (transaction_a);
 	}
-	last_tally = block_weights;
+}
+
+nano::tally_t nano::election::tally (nano::transaction const & transaction_a)
+{
+	tally_refresh (transaction_a);
 	nano::tally_t result;
-	for (auto item : block_weights)
+	for (auto const & item : last_tally)
 	{
 		auto block (blocks.find (item.first));
 		if (block != blocks.end ())
@@ -103,6 +121,18 @@ nano::tally_t nano::election::tally (nano::transaction const & transaction_a)
 	return result;
 }
 
+void nano::election::tally_recompute (nano::transaction const & transaction_a)
+{
+	tally_generation = node.ledger.rep_weights.generation ();
+	tally_recomputed = std::chrono::steady_clock::now ();
+	last_tally.clear ();
+	for (auto & vote_info : last_votes)
+	{
+		vote_info.second.weight = node.ledger.weight (transaction_a, vote_info.first);
+		last_tally[vote_info.second.hash] += vote_info.second.weight;
+	}
+}
+
 void nano::election::confirm_if_quorum (nano::transaction const & transaction_a)
 {
 	auto tally_l (tally (transaction_a));
@@ -120,6 +150,7 @@ void nano::election::confirm_if_quorum (nano::transaction const & transaction_a)
 		auto node_l (node.shared ());
 		node_l->block_processor.force (block_l);
 		status.winner = block_l;
+		winner_hash = block_l->hash ();
 		update_dependent ();
 		node_l->active.adjust_difficulty (block_l->hash ());
 	}
@@ -157,6 +188,7 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 	auto online_stake (node.online_reps.online_stake ());
 	auto weight (node.ledger.weight (transaction, rep));
 	auto should_process (false);
+	auto confirm_check (false);
 	if (node.network_params.network.is_test_network () || weight > node.minimum_principal_weight (online_stake))
 	{
 		unsigned int cooldown;
@@ -172,6 +204,7 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 		{
 			cooldown = 1;
 		}
+		std::lock_guard<std::mutex> lock (mutex);
 		auto last_vote_it (last_votes.find (rep));
 		if (last_vote_it == last_votes.end ())
 		{
@@ -194,22 +227,61 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 		}
 		if (should_process)
 		{
-			last_votes[rep] = { std::chrono::steady_clock::now (), sequence, block_hash };
+			// Move the representative's weight from its previous vote instead of recounting every vote
+			nano::block_hash previous_hash (0);
+			if (last_vote_it != last_votes.end ())
+			{
+				previous_hash = last_vote_it->second.hash;
+				last_tally[previous_hash] -= last_vote_it->second.weight;
+			}
+			last_votes[rep] = { std::chrono::steady_clock::now (), sequence, block_hash, weight };
+			last_tally[block_hash] += weight;
+			if (!previous_hash.is_zero () && last_tally[previous_hash] == 0 && std::none_of (last_votes.begin (), last_votes.end (), [&previous_hash](auto const & vote_a) { return vote_a.second.hash == previous_hash; }))
+			{
+				// A block nobody votes for is left out of the tally
+				last_tally.erase (previous_hash);
+			}
 			if (!confirmed)
 			{
-				confirm_if_quorum (transaction);
+				tally_refresh (transaction);
+				confirm_check = confirm_check_required ();
 			}
 		}
 	}
-	return nano::election_vote_result (replay, should_process);
+	nano::election_vote_result result (replay, should_process);
+	result.confirm_check = confirm_check;
+	return result;
+}
+
+bool nano::election::confirm_check_required ()
+{
+	// Conservative version of confirm_if_quorum on the raw tally: votes which can neither change the winner nor reach quorum do not need node.active.mutex
+	nano::uint128_t sum (0);
+	nano::uint128_t winner_weight (0);
+	nano::uint128_t other_weight (0);
+	for (auto const & item : last_tally)
+	{
+		sum += item.second;
+		if (item.first == winner_hash)
+		{
+			winner_weight = item.second;
+		}
+		else
+		{
+			other_weight = std::max (other_weight, item.second);
+		}
+	}
+	return sum >= node.config.online_weight_minimum.number () && (other_weight >= winner_weight || winner_weight > node.delta ());
 }
 
 bool nano::election::publish (std::shared_ptr<nano::block> block_a)
 {
+	std::lock_guard<std::mutex> lock (mutex);
 	auto result (false);
 	if (blocks.size () >= 10)
 	{
-		if (last_tally[block_a->hash ()] < node.online_reps.online_stake () / 10)
+		auto existing (last_tally.find (block_a->hash ()));
+		if (existing == last_tally.end () || existing->second < node.online_reps.online_stake () / 10)
 		{
 			result = true;
 		}
@@ -237,7 +309,7 @@ bool nano::election::publish (std::shared_ptr<nano::block> block_a)
 
 size_t nano::election::last_votes_size ()
 {
-	std::lock_guard<std::mutex> lock (node.active.mutex);
+	std::lock_guard<std::mutex> lock (mutex);
 	return last_votes.size ();
 }
 
@@ -276,10 +348,7 @@ void nano::election::update_dependent ()
 
 void nano::election::clear_dependent ()
 {
-	for (auto & dependent_block : dependent_blocks)
-	{
-		node.active.adjust_difficulty (dependent_block);
-	}
+	node.active.adjust_difficulty (std::vector<nano::block_hash> (dependent_blocks.begin (), dependent_blocks.end ()));
 }
 
 void nano::election::clear_blocks ()
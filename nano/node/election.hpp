@@ -8,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 
 namespace nano
@@ -20,6 +21,8 @@ public:
 	std::chrono::steady_clock::time_point time;
 	uint64_t sequence;
 	nano::block_hash hash;
+	/** Representative weight counted towards hash in the election tally */
+	nano::uint128_t weight{ 0 };
 };
 class election_vote_result final
 {
@@ -28,6 +31,8 @@ public:
 	election_vote_result (bool, bool);
 	bool replay{ false };
 	bool processed{ false };
+	/** The tally may now confirm the election or change its winner, which is checked under node.active.mutex */
+	bool confirm_check{ false };
 };
 class election final : public std::enable_shared_from_this<nano::election>
 {
@@ -35,14 +40,18 @@ class election final : public std::enable_shared_from_this<nano::election>
 
 public:
 	election (nano::node &, std::shared_ptr<nano::block>, std::function<void(std::shared_ptr<nano::block>)> const &);
+	/** Applies a vote holding only the election mutex */
 	nano::election_vote_result vote (nano::account, uint64_t, nano::block_hash);
+	/** Note: election mutex lock is required */
 	nano::tally_t tally (nano::transaction const &);
+	/** Recounts every vote with current representative weights */
+	void tally_recompute (nano::transaction const &);
 	// Check if we have vote quorum
 	bool have_quorum (nano::tally_t const &, nano::uint128_t) const;
 	// Change our winner to agree with the network
 	void compute_rep_votes (nano::transaction const &);
 	void confirm_once (nano::election_status_type = nano::election_status_type::active_confirmed_quorum);
-	// Confirm this block if quorum is met
+	// Confirm this block if quorum is met, node.active.mutex and election mutex locks are required
 	void confirm_if_quorum (nano::transaction const &);
 	void log_votes (nano::tally_t const &) const;
 	bool publish (std::shared_ptr<nano::block> block_a);
@@ -52,14 +61,27 @@ public:
 	void clear_blocks ();
 	void stop ();
 	nano::node & node;
+	/** Guards votes and tallies so votes for different elections are applied concurrently, taken after node.active.mutex when both are needed */
+	std::mutex mutex;
 	std::unordered_map<nano::account, nano::vote_info> last_votes;
 	std::unordered_map<nano::block_hash, std::shared_ptr<nano::block>> blocks;
 	std::chrono::steady_clock::time_point election_start;
 	nano::election_status status;
+	/** Hash of the winner, readable under the election mutex alone */
+	nano::block_hash winner_hash;
 	std::atomic<bool> confirmed;
 	bool stopped;
+	/** Vote weight per block, adjusted as votes change and recomputed when representative weights have changed */
 	std::unordered_map<nano::block_hash, nano::uint128_t> last_tally;
+	uint64_t tally_generation;
+	std::chrono::steady_clock::time_point tally_recomputed;
 	unsigned confirmation_request_count;
+	/** Request loop pass at which this election is next due for a confirmation request */
+	uint64_t request_tick{ 0 };
 	std::unordered_set<nano::block_hash> dependent_blocks;
+
+private:
+	void tally_refresh (nano::transaction const &);
+	bool confirm_check_required ();
 };
 }
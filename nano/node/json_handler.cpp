@@ -1604,6 +1604,22 @@ void nano::json_handler::bootstrap_status ()
 		response_l.put ("target_connections", std::to_string (attempt->target_connections (attempt->pulls.size ())));
 		response_l.put ("total_blocks", std::to_string (attempt->total_blocks));
 		response_l.put ("runs_count", std::to_string (attempt->runs_count));
+		boost::property_tree::ptree throttled;
+		{
+			std::lock_guard<std::mutex> lock (attempt->mutex);
+			for (auto const & i : attempt->clients)
+			{
+				if (auto client = i.lock ())
+				{
+					std::stringstream endpoint_text;
+					endpoint_text << client->channel->socket->remote_endpoint ();
+					boost::property_tree::ptree entry;
+					entry.put ("", std::to_string (client->throttled_ms));
+					throttled.push_back (boost::property_tree::ptree::value_type (endpoint_text.str (), entry));
+				}
+			}
+		}
+		response_l.add_child ("throttled_ms", throttled);
 		std::string mode_text;
 		if (attempt->mode == nano::bootstrap_mode::legacy)
 		{
@@ -1636,6 +1652,33 @@ void nano::json_handler::bootstrap_status ()
 	response_errors ();
 }
 
+/*
+ * @warning This is an internal/diagnostic RPC, do not rely on its interface being stable
+ */
+void nano::json_handler::bootstrap_scores ()
+{
+	boost::property_tree::ptree peers;
+	for (auto const & score : node.bootstrap_initiator.peer_scores.list ())
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("score", score.score ());
+		entry.put ("block_rate", score.block_rate ());
+		entry.put ("latency", std::to_string (score.latency.count ()));
+		entry.put ("requests", std::to_string (score.requests));
+		entry.put ("failures", std::to_string (score.failures));
+		entry.put ("failure_rate", score.failure_rate ());
+		entry.put ("blocks", std::to_string (score.blocks));
+		entry.put ("invalid_blocks", std::to_string (score.invalid_blocks));
+		entry.put ("validity", score.validity ());
+		entry.put ("usable", node.bootstrap_initiator.peer_scores.usable (score.endpoint));
+		std::stringstream endpoint_text;
+		endpoint_text << score.endpoint;
+		peers.push_back (boost::property_tree::ptree::value_type (endpoint_text.str (), entry));
+	}
+	response_l.add_child ("peers", peers);
+	response_errors ();
+}
+
 void nano::json_handler::chain (bool successors)
 {
 	successors = successors != request.get<bool> ("reverse", false);
@@ -1768,6 +1811,7 @@ void nano::json_handler::confirmation_info ()
 			nano::uint128_t total (0);
 			response_l.put ("last_winner", election->status.winner->hash ().to_string ());
 			auto transaction (node.store.tx_begin_read ());
+			std::lock_guard<std::mutex> election_lock (election->mutex);
 			auto tally_l (election->tally (transaction));
 			boost::property_tree::ptree blocks;
 			for (auto i (tally_l.begin ()), n (tally_l.end ()); i != n; ++i)
@@ -4660,6 +4704,7 @@ ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
 	no_arg_funcs.emplace ("bootstrap", &nano::json_handler::bootstrap);
 	no_arg_funcs.emplace ("bootstrap_any", &nano::json_handler::bootstrap_any);
 	no_arg_funcs.emplace ("bootstrap_lazy", &nano::json_handler::bootstrap_lazy);
+	no_arg_funcs.emplace ("bootstrap_scores", &nano::json_handler::bootstrap_scores);
 	no_arg_funcs.emplace ("bootstrap_status", &nano::json_handler::bootstrap_status);
 	no_arg_funcs.emplace ("confirmation_active", &nano::json_handler::confirmation_active);
 	no_arg_funcs.emplace ("confirmation_height_currently_processing", &nano::json_handler::confirmation_height_currently_processing);
@@ -52,6 +52,7 @@ public:
 	void bootstrap ();
 	void bootstrap_any ();
 	void bootstrap_lazy ();
+	void bootstrap_scores ();
 	void bootstrap_status ();
 	void chain (bool = false);
 	void confirmation_active ();
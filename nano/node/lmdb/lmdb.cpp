@@ -139,6 +139,7 @@ void nano::mdb_store::open_databases (bool & error_a, nano::transaction const &
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "meta", flags, &meta) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "peers", flags, &peers) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "confirmation_height", flags, &confirmation_height) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "bootstrap", flags, &bootstrap) != 0;
 	if (!full_sideband (transaction_a))
 	{
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "blocks_info", flags, &blocks_info) != 0;
@@ -179,6 +180,8 @@ bool nano::mdb_store::do_upgrades (nano::write_transaction & transaction_a, size
 		case 14:
 			upgrade_v14_to_v15 (transaction_a);
 		case 15:
+			upgrade_v15_to_v16 (transaction_a);
+		case 16:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -505,6 +508,12 @@ void nano::mdb_store::upgrade_v14_to_v15 (nano::write_transaction const & transa
 	}
 }
 
+void nano::mdb_store::upgrade_v15_to_v16 (nano::write_transaction const & transaction_a)
+{
+	// The bootstrap checkpoint table is created empty when opening the databases
+	version_put (transaction_a, 16);
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void nano::mdb_store::create_backup_file (nano::mdb_env & env_a, boost::filesystem::path const & filepath_a, nano::logger_mt & logger_a)
 {
@@ -663,6 +672,8 @@ MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 			return peers;
 		case tables::confirmation_height:
 			return confirmation_height;
+		case tables::bootstrap:
+			return bootstrap;
 		default:
 			release_assert (false);
 			return peers;
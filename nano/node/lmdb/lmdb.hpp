@@ -165,6 +165,12 @@ public:
 	 */
 	MDB_dbi confirmation_height{ 0 };
 
+	/*
+	 * Outstanding pulls of an interrupted legacy bootstrap
+	 * nano::account -> nano::pull_checkpoint
+	 */
+	MDB_dbi bootstrap{ 0 };
+
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
 	int get (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, nano::mdb_val & value_a) const;
@@ -214,6 +220,7 @@ private:
 	void upgrade_v12_to_v13 (nano::write_transaction &, size_t);
 	void upgrade_v13_to_v14 (nano::write_transaction const &);
 	void upgrade_v14_to_v15 (nano::write_transaction const &);
+	void upgrade_v15_to_v16 (nano::write_transaction const &);
 	void open_databases (bool &, nano::transaction const &, unsigned);
 
 	int drop (nano::write_transaction const & transaction_a, tables table_a) override;
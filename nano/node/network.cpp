@@ -4,7 +4,15 @@
 #include <numeric>
 #include <sstream>
 
+size_t constexpr nano::confirm_req_scheduler::max_outstanding;
+size_t constexpr nano::confirm_req_scheduler::max_queued;
+std::chrono::milliseconds constexpr nano::confirm_req_scheduler::default_latency;
+std::chrono::seconds constexpr nano::confirm_req_scheduler::idle_cutoff;
+std::chrono::milliseconds constexpr nano::confirm_req_scheduler::flush_interval;
+
 nano::network::network (nano::node & node_a, uint16_t port_a) :
+duplicates (64 * 1024),
+confirm_reqs (node_a),
 buffer_container (node_a.stats, nano::network::buffer_size, 4096), // 2Mb receive buffer
 resolver (node_a.io_ctx),
 node (node_a),
@@ -127,76 +135,11 @@ void nano::network::send_node_id_handshake (std::shared_ptr<nano::transport::cha
 	channel_a->send (message);
 }
 
-template <typename T>
-bool confirm_block (nano::transaction const & transaction_a, nano::node & node_a, T & list_a, std::shared_ptr<nano::block> block_a, bool also_publish)
-{
-	bool result (false);
-	if (node_a.config.enable_voting)
-	{
-		auto hash (block_a->hash ());
-		// Search in cache
-		auto votes (node_a.votes_cache.find (hash));
-		if (votes.empty ())
-		{
-			// Generate new vote
-			node_a.wallets.foreach_representative (transaction_a, [&result, &list_a, &node_a, &transaction_a, &hash](nano::public_key const & pub_a, nano::raw_key const & prv_a) {
-				result = true;
-				auto vote (node_a.store.vote_generate (transaction_a, pub_a, prv_a, std::vector<nano::block_hash> (1, hash)));
-				nano::confirm_ack confirm (vote);
-				for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
-				{
-					j->get ()->send (confirm);
-				}
-				node_a.votes_cache.add (vote);
-			});
-		}
-		else
-		{
-			// Send from cache
-			for (auto & vote : votes)
-			{
-				nano::confirm_ack confirm (vote);
-				for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
-				{
-					j->get ()->send (confirm);
-				}
-			}
-		}
-		// Republish if required
-		if (also_publish)
-		{
-			nano::publish publish (block_a);
-			for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
-			{
-				j->get ()->send (publish);
-			}
-		}
-	}
-	return result;
-}
-
-bool confirm_block (nano::transaction const & transaction_a, nano::node & node_a, std::shared_ptr<nano::transport::channel> channel_a, std::shared_ptr<nano::block> block_a, bool also_publish)
-{
-	std::array<std::shared_ptr<nano::transport::channel>, 1> endpoints = { channel_a };
-	auto result (confirm_block (transaction_a, node_a, endpoints, std::move (block_a), also_publish));
-	return result;
-}
-
-void nano::network::confirm_hashes (nano::transaction const & transaction_a, std::shared_ptr<nano::transport::channel> channel_a, std::vector<nano::block_hash> blocks_bundle_a)
+void nano::network::confirm_hashes (std::shared_ptr<nano::transport::channel> channel_a, std::vector<nano::block_hash> const & blocks_bundle_a)
 {
 	if (node.config.enable_voting)
 	{
-		node.wallets.foreach_representative (transaction_a, [this, &blocks_bundle_a, &channel_a, &transaction_a](nano::public_key const & pub_a, nano::raw_key const & prv_a) {
-			auto vote (this->node.store.vote_generate (transaction_a, pub_a, prv_a, blocks_bundle_a));
-			nano::confirm_ack confirm (vote);
-			std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
-			{
-				nano::vectorstream stream (*bytes);
-				confirm.serialize (stream);
-			}
-			channel_a->send (confirm);
-			this->node.votes_cache.add (vote);
-		});
+		node.vote_aggregator.add (channel_a, blocks_bundle_a);
 	}
 }
 
@@ -209,6 +152,7 @@ bool nano::network::send_votes_cache (std::shared_ptr<nano::transport::channel>
 	{
 		nano::confirm_ack confirm (vote);
 		channel_a->send (confirm);
+		node.stats.inc (nano::stat::type::vote, nano::stat::detail::vote_cached);
 	}
 	// Returns true if votes were sent
 	bool result (!votes.empty ());
@@ -319,51 +263,6 @@ void nano::network::broadcast_confirm_req_base (std::shared_ptr<nano::block> blo
 	}
 }
 
-void nano::network::broadcast_confirm_req_batch (std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> request_bundle_a, unsigned delay_a, bool resumption)
-{
-	const size_t max_reps = 50;
-	if (!resumption && node.config.logging.network_logging ())
-	{
-		node.logger.try_log (boost::str (boost::format ("Broadcasting batch confirm req to %1% representatives") % request_bundle_a.size ()));
-	}
-	auto count (0);
-	while (!request_bundle_a.empty () && count < max_reps)
-	{
-		auto j (request_bundle_a.begin ());
-		while (j != request_bundle_a.end ())
-		{
-			count++;
-			std::vector<std::pair<nano::block_hash, nano::block_hash>> roots_hashes;
-			// Limit max request size hash + root to 7 pairs
-			while (roots_hashes.size () <= confirm_req_hashes_max && !j->second.empty ())
-			{
-				roots_hashes.push_back (j->second.back ());
-				j->second.pop_back ();
-			}
-			nano::confirm_req req (roots_hashes);
-			j->first->send (req);
-			if (j->second.empty ())
-			{
-				j = request_bundle_a.erase (j);
-			}
-			else
-			{
-				++j;
-			}
-		}
-	}
-	if (!request_bundle_a.empty ())
-	{
-		std::weak_ptr<nano::node> node_w (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (delay_a), [node_w, request_bundle_a, delay_a]() {
-			if (auto node_l = node_w.lock ())
-			{
-				node_l->network.broadcast_confirm_req_batch (request_bundle_a, delay_a, true);
-			}
-		});
-	}
-}
-
 void nano::network::broadcast_confirm_req_batch (std::deque<std::pair<std::shared_ptr<nano::block>, std::shared_ptr<std::vector<std::shared_ptr<nano::transport::channel>>>>> deque_a, unsigned delay_a)
 {
 	auto pair (deque_a.front ());
@@ -415,6 +314,10 @@ public:
 			node.logger.try_log (boost::str (boost::format ("Publish message from %1% for %2%") % channel->to_string () % message_a.block->hash ().to_string ()));
 		}
 		node.stats.inc (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in);
+		if (node.network.duplicates.apply (message_a.block->block_signature ()))
+		{
+			node.stats.inc (nano::stat::type::duplicate, nano::stat::detail::publish, nano::stat::dir::in);
+		}
 		if (!node.block_processor.full ())
 		{
 			node.process_active (message_a.block);
@@ -451,8 +354,17 @@ public:
 					auto successor (node.ledger.successor (transaction, message_a.block->qualified_root ()));
 					if (successor != nullptr)
 					{
-						auto same_block (successor->hash () == hash);
-						confirm_block (transaction, node, channel, std::move (successor), !same_block);
+						auto successor_hash (successor->hash ());
+						if (successor_hash != hash)
+						{
+							nano::publish publish (successor);
+							channel->send (publish);
+						}
+						// The requested hash missed the cache already, a fork may still have cached votes for our successor
+						if (successor_hash == hash || !node.network.send_votes_cache (channel, successor_hash))
+						{
+							node.network.confirm_hashes (channel, std::vector<nano::block_hash> (1, successor_hash));
+						}
 					}
 				}
 			}
@@ -509,7 +421,7 @@ public:
 				Otherwise use more bandwidth & save local resources required to sign vote */
 				if (!blocks_bundle.empty () && cached_count < blocks_bundle.size ())
 				{
-					node.network.confirm_hashes (transaction, channel, blocks_bundle);
+					node.network.confirm_hashes (channel, blocks_bundle);
 				}
 				else
 				{
@@ -518,6 +430,7 @@ public:
 					{
 						nano::confirm_ack confirm (vote);
 						channel->send (confirm);
+						node.stats.inc (nano::stat::type::vote, nano::stat::detail::vote_cached);
 					}
 				}
 			}
@@ -530,6 +443,10 @@ public:
 			node.logger.try_log (boost::str (boost::format ("Received confirm_ack message from %1% for %2%sequence %3%") % channel->to_string () % message_a.vote->hashes_string () % std::to_string (message_a.vote->sequence)));
 		}
 		node.stats.inc (nano::stat::type::message, nano::stat::detail::confirm_ack, nano::stat::dir::in);
+		if (node.network.duplicates.apply (message_a.vote->signature))
+		{
+			node.stats.inc (nano::stat::type::duplicate, nano::stat::detail::confirm_ack, nano::stat::dir::in);
+		}
 		for (auto & vote_block : message_a.vote->blocks)
 		{
 			if (!vote_block.which ())
@@ -546,6 +463,7 @@ public:
 				node.active.publish (block);
 			}
 		}
+		node.network.confirm_reqs.response (channel, message_a.vote);
 		node.vote_processor.vote (message_a.vote, channel);
 	}
 	void bulk_pull (nano::bulk_pull const &) override
@@ -646,9 +564,57 @@ std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list (size_
 }
 
 // Simulating with sqrt_broadcast_simulate shows we only need to broadcast to sqrt(total_peers) random peers in order to successfully publish to everyone with high probability
+// Half of the fanout is given to representatives, drawn with probability proportional to their weight, so blocks and votes reach voting weight in fewer hops
 std::deque<std::shared_ptr<nano::transport::channel>> nano::network::list_fanout ()
 {
-	auto result (list (size_sqrt ()));
+	auto fanout (size_sqrt ());
+	std::deque<std::shared_ptr<nano::transport::channel>> result;
+	std::unordered_set<std::shared_ptr<nano::transport::channel>> included;
+	auto reps (node.rep_crawler.representatives_by_weight ());
+	std::vector<double> weights;
+	weights.reserve (reps.size ());
+	auto total (0.0);
+	for (auto & rep : reps)
+	{
+		weights.push_back (rep.weight.number ().convert_to<double> ());
+		total += weights.back ();
+	}
+	// Weighted draws without replacement, a drawn rep has its weight zeroed
+	auto remaining (reps.size ());
+	for (auto picks (fanout / 2); picks > 0 && remaining > 0; --remaining)
+	{
+		auto target (total * nano::random_pool::generate_word32 (0, std::numeric_limits<uint32_t>::max ()) / std::numeric_limits<uint32_t>::max ());
+		auto selected (reps.size ());
+		for (size_t i (0), n (reps.size ()); i < n; ++i)
+		{
+			if (weights[i] > 0)
+			{
+				selected = i;
+				if (target < weights[i])
+				{
+					break;
+				}
+				target -= weights[i];
+			}
+		}
+		assert (selected < reps.size ());
+		total -= weights[selected];
+		weights[selected] = 0;
+		// Several rep accounts can share a channel
+		if (included.insert (reps[selected].channel).second)
+		{
+			result.push_back (reps[selected].channel);
+			--picks;
+		}
+	}
+	auto peers (list (fanout + result.size ()));
+	for (auto i (peers.begin ()), n (peers.end ()); i != n && result.size () < fanout; ++i)
+	{
+		if (included.insert (*i).second)
+		{
+			result.push_back (*i);
+		}
+	}
 	return result;
 }
 
@@ -683,6 +649,26 @@ void nano::network::random_fill (std::array<nano::endpoint, 8> & target_a) const
 	}
 }
 
+nano::duplicate_filter::duplicate_filter (size_t size_a) :
+items (new std::atomic<uint64_t>[size_a]),
+size (size_a)
+{
+	assert (size > 0);
+	for (size_t i (0); i < size; ++i)
+	{
+		items[i] = 0;
+	}
+}
+
+bool nano::duplicate_filter::apply (nano::signature const & signature_a)
+{
+	// Signatures are uniformly distributed, one half picks the slot and the other is stored as the tag
+	auto & item (items[signature_a.qwords[0] % size]);
+	auto tag (signature_a.qwords[1] != 0 ? signature_a.qwords[1] : 1);
+	auto result (item.exchange (tag, std::memory_order_relaxed) == tag);
+	return result;
+}
+
 nano::tcp_endpoint nano::network::bootstrap_peer ()
 {
 	nano::tcp_endpoint result (boost::asio::ip::address_v6::any (), 0);
@@ -1037,3 +1023,196 @@ std::unique_ptr<nano::seq_con_info_component> nano::syn_cookies::collect_seq_con
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "syn_cookies_per_ip", syn_cookies_per_ip_count, sizeof (decltype (cookies_per_ip)::value_type) }));
 	return composite;
 }
+
+nano::confirm_req_scheduler::confirm_req_scheduler (nano::node & node_a) :
+node (node_a)
+{
+}
+
+void nano::confirm_req_scheduler::request (std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> const & requests_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	auto now (std::chrono::steady_clock::now ());
+	for (auto & request : requests_a)
+	{
+		auto & rep (representatives[request.first->get_endpoint ()]);
+		// Replace channels which were reconnected on the same endpoint
+		rep.channel = request.first;
+		rep.last_active = now;
+		auto timeout_l (timeout (rep));
+		for (auto & hash_root : request.second)
+		{
+			auto existing (rep.outstanding.find (hash_root.first));
+			if (existing != rep.outstanding.end ())
+			{
+				if (existing->second + timeout_l > now)
+				{
+					continue;
+				}
+				rep.outstanding.erase (existing);
+			}
+			if (rep.queue.size () < max_queued && rep.queued.insert (hash_root.first).second)
+			{
+				rep.queue.push_back (hash_root);
+			}
+		}
+	}
+	flush_impl (lock);
+}
+
+void nano::confirm_req_scheduler::flush ()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	flush_scheduled = false;
+	flush_impl (lock);
+}
+
+void nano::confirm_req_scheduler::flush_impl (std::unique_lock<std::mutex> & lock_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	std::vector<std::pair<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>>> sends;
+	auto pending (false);
+	for (auto i (representatives.begin ()), n (representatives.end ()); i != n;)
+	{
+		auto & rep (i->second);
+		auto timeout_l (timeout (rep));
+		for (auto j (rep.outstanding.begin ()), m (rep.outstanding.end ()); j != m;)
+		{
+			j = (j->second + timeout_l <= now) ? rep.outstanding.erase (j) : std::next (j);
+		}
+		size_t hashes_max (nano::network::confirm_req_hashes_max);
+		if (rep.channel->get_type () == nano::transport::transport_type::tcp)
+		{
+			hashes_max = nano::network::confirm_req_hashes_max_tcp;
+		}
+		while (!rep.queue.empty () && rep.outstanding.size () < max_outstanding)
+		{
+			std::vector<std::pair<nano::block_hash, nano::block_hash>> roots_hashes;
+			while (roots_hashes.size () < hashes_max && !rep.queue.empty () && rep.outstanding.size () < max_outstanding)
+			{
+				auto hash_root (rep.queue.front ());
+				rep.queue.pop_front ();
+				// Pairs answered while queued were removed from the set and are skipped
+				if (rep.queued.erase (hash_root.first) > 0)
+				{
+					rep.outstanding.emplace (hash_root.first, now);
+					roots_hashes.push_back (hash_root);
+				}
+			}
+			if (!roots_hashes.empty ())
+			{
+				sends.emplace_back (rep.channel, std::move (roots_hashes));
+			}
+		}
+		pending = pending || !rep.queue.empty ();
+		if (rep.queue.empty () && rep.outstanding.empty () && rep.last_active + idle_cutoff <= now)
+		{
+			i = representatives.erase (i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+	auto schedule (pending && !flush_scheduled);
+	flush_scheduled = flush_scheduled || pending;
+	lock_a.unlock ();
+	for (auto & send : sends)
+	{
+		nano::confirm_req req (send.second);
+		send.first->send (req);
+	}
+	if (schedule)
+	{
+		std::weak_ptr<nano::node> node_w (node.shared ());
+		node.alarm.add (now + flush_interval, [node_w]() {
+			if (auto node_l = node_w.lock ())
+			{
+				node_l->network.confirm_reqs.flush ();
+			}
+		});
+	}
+}
+
+void nano::confirm_req_scheduler::response (std::shared_ptr<nano::transport::channel> channel_a, std::shared_ptr<nano::vote> vote_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (representatives.find (channel_a->get_endpoint ()));
+	if (existing != representatives.end ())
+	{
+		auto now (std::chrono::steady_clock::now ());
+		auto & rep (existing->second);
+		rep.last_active = now;
+		for (auto const & hash : *vote_a)
+		{
+			auto outstanding (rep.outstanding.find (hash));
+			if (outstanding != rep.outstanding.end ())
+			{
+				// Moving average over the last few responses
+				auto sample (std::chrono::duration_cast<std::chrono::milliseconds> (now - outstanding->second));
+				rep.latency = (rep.latency * 7 + sample) / 8;
+				rep.outstanding.erase (outstanding);
+			}
+			else
+			{
+				rep.queued.erase (hash);
+			}
+		}
+	}
+}
+
+std::chrono::milliseconds nano::confirm_req_scheduler::timeout (representative const & rep_a) const
+{
+	// Unanswered pairs are retried after twice the observed latency, but not sooner than the request loop would ask again
+	return std::max (rep_a.latency * 2, std::chrono::milliseconds (node.network_params.network.request_interval_ms));
+}
+
+size_t nano::confirm_req_scheduler::queued_size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	size_t result (0);
+	for (auto & rep : representatives)
+	{
+		result += rep.second.queued.size ();
+	}
+	return result;
+}
+
+size_t nano::confirm_req_scheduler::outstanding_size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	size_t result (0);
+	for (auto & rep : representatives)
+	{
+		result += rep.second.outstanding.size ();
+	}
+	return result;
+}
+
+std::chrono::milliseconds nano::confirm_req_scheduler::latency (nano::endpoint const & endpoint_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (representatives.find (endpoint_a));
+	return existing != representatives.end () ? existing->second.latency : default_latency;
+}
+
+std::unique_ptr<nano::seq_con_info_component> nano::confirm_req_scheduler::collect_seq_con_info (std::string const & name)
+{
+	size_t representatives_count = 0;
+	size_t queued_count = 0;
+	size_t outstanding_count = 0;
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		representatives_count = representatives.size ();
+		for (auto & rep : representatives)
+		{
+			queued_count += rep.second.queue.size ();
+			outstanding_count += rep.second.outstanding.size ();
+		}
+	}
+	auto composite = std::make_unique<seq_con_info_composite> (name);
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "representatives", representatives_count, sizeof (decltype (representatives)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "queued", queued_count, sizeof (decltype (representative::queue)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "outstanding", outstanding_count, sizeof (decltype (representative::outstanding)::value_type) }));
+	return composite;
+}
@@ -107,6 +107,70 @@ private:
 	std::unordered_map<nano::endpoint, syn_cookie_info> cookies;
 	std::unordered_map<boost::asio::ip::address, unsigned> cookies_per_ip;
 };
+/**
+  * Lossy record of recently received blocks and votes, keyed by signature, used to measure how often
+  * the same item is delivered more than once. Colliding items evict each other so duplicates can be
+  * undercounted but are not overcounted.
+*/
+class duplicate_filter final
+{
+public:
+	explicit duplicate_filter (size_t);
+	// Records the item, returns true if it was recorded already
+	bool apply (nano::signature const &);
+
+private:
+	std::unique_ptr<std::atomic<uint64_t>[]> items;
+	size_t const size;
+};
+/**
+ * Batches confirm_req by hash and root to each representative, tracking which pairs it was asked for and has not answered.
+ * A pair outstanding or queued to a representative is not requested again until it times out, and pairs the representative votes on are dropped.
+ * Each representative has a window of unanswered pairs that refills as its votes arrive, and timeouts follow its observed response latency.
+ */
+class confirm_req_scheduler final
+{
+public:
+	explicit confirm_req_scheduler (nano::node &);
+	/** Queues the pairs for each channel and sends what fits in the windows */
+	void request (std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>> const &);
+	/** Expires unanswered pairs and sends queued pairs to representatives with room in their window */
+	void flush ();
+	/** Marks the hashes in \p vote_a as answered by the representative on \p channel_a and updates its latency */
+	void response (std::shared_ptr<nano::transport::channel>, std::shared_ptr<nano::vote>);
+	size_t queued_size ();
+	size_t outstanding_size ();
+	std::chrono::milliseconds latency (nano::endpoint const &);
+	std::unique_ptr<seq_con_info_component> collect_seq_con_info (std::string const &);
+	/** Unanswered pairs allowed per representative */
+	static size_t constexpr max_outstanding = 256;
+	/** Pairs waiting per representative, beyond that new pairs are left for the next request round */
+	static size_t constexpr max_queued = 4096;
+	/** Latency assumed for a representative before any of its votes arrive */
+	static std::chrono::milliseconds constexpr default_latency = std::chrono::milliseconds (1000);
+	/** Idle representatives are kept this long so their latency carries over to the next request round */
+	static std::chrono::seconds constexpr idle_cutoff = std::chrono::seconds (300);
+	static std::chrono::milliseconds constexpr flush_interval = std::chrono::milliseconds (50);
+
+private:
+	class representative final
+	{
+	public:
+		std::shared_ptr<nano::transport::channel> channel;
+		std::deque<std::pair<nano::block_hash, nano::block_hash>> queue;
+		std::unordered_set<nano::block_hash> queued;
+		std::unordered_map<nano::block_hash, std::chrono::steady_clock::time_point> outstanding;
+		std::chrono::milliseconds latency{ default_latency };
+		/** Last time pairs were requested from or answered by the representative */
+		std::chrono::steady_clock::time_point last_active;
+	};
+	std::chrono::milliseconds timeout (representative const &) const;
+	void flush_impl (std::unique_lock<std::mutex> &);
+	nano::node & node;
+	std::mutex mutex;
+	std::unordered_map<nano::endpoint, representative> representatives;
+	bool flush_scheduled{ false };
+};
 class network final
 {
 public:
@@ -141,9 +205,8 @@ public:
 	void send_confirm_req (std::shared_ptr<nano::transport::channel>, std::shared_ptr<nano::block>);
 	void broadcast_confirm_req (std::shared_ptr<nano::block>);
 	void broadcast_confirm_req_base (std::shared_ptr<nano::block>, std::shared_ptr<std::vector<std::shared_ptr<nano::transport::channel>>>, unsigned, bool = false);
-	void broadcast_confirm_req_batch (std::unordered_map<std::shared_ptr<nano::transport::channel>, std::vector<std::pair<nano::block_hash, nano::block_hash>>>, unsigned = broadcast_interval_ms, bool = false);
 	void broadcast_confirm_req_batch (std::deque<std::pair<std::shared_ptr<nano::block>, std::shared_ptr<std::vector<std::shared_ptr<nano::transport::channel>>>>>, unsigned = broadcast_interval_ms);
-	void confirm_hashes (nano::transaction const &, std::shared_ptr<nano::transport::channel>, std::vector<nano::block_hash>);
+	void confirm_hashes (std::shared_ptr<nano::transport::channel>, std::vector<nano::block_hash> const &);
 	bool send_votes_cache (std::shared_ptr<nano::transport::channel>, nano::block_hash const &);
 	std::shared_ptr<nano::transport::channel> find_node_id (nano::account const &);
 	std::shared_ptr<nano::transport::channel> find_channel (nano::endpoint const &);
@@ -152,7 +215,7 @@ public:
 	// Should we reach out to this endpoint with a keepalive message
 	bool reachout (nano::endpoint const &, bool = false);
 	std::deque<std::shared_ptr<nano::transport::channel>> list (size_t);
-	// A list of random peers sized for the configured rebroadcast fanout
+	// A list of peers sized for the configured rebroadcast fanout, part of it representatives picked by weight
 	std::deque<std::shared_ptr<nano::transport::channel>> list_fanout ();
 	void random_fill (std::array<nano::endpoint, 8> &) const;
 	std::unordered_set<std::shared_ptr<nano::transport::channel>> random_set (size_t) const;
@@ -166,6 +229,10 @@ public:
 	void ongoing_cleanup ();
 	// Node ID cookies cleanup
 	nano::syn_cookies syn_cookies;
+	// Duplicate publish and confirm_ack detection for the duplicate stats
+	nano::duplicate_filter duplicates;
+	// Batched confirm_req by hash to representatives
+	nano::confirm_req_scheduler confirm_reqs;
 	void ongoing_syn_cookie_cleanup ();
 	void ongoing_keepalive ();
 	size_t size () const;
@@ -182,6 +249,9 @@ public:
 	std::function<void(std::shared_ptr<nano::transport::channel>)> channel_observer;
 	static unsigned const broadcast_interval_ms = 10;
 	static size_t const buffer_size = 512;
+	// Pairs per confirm_req that fit the UDP receive buffer
 	static size_t const confirm_req_hashes_max = 7;
+	// Pairs per confirm_req over TCP, as many hashes as a single vote answers
+	static size_t const confirm_req_hashes_max_tcp = 12;
 };
 }
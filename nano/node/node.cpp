@@ -85,6 +85,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_processor &
 	size_t state_blocks_count = 0;
 	size_t blocks_count = 0;
 	size_t blocks_hashes_count = 0;
+	size_t deferred_count = 0;
 	size_t forced_count = 0;
 	size_t rolled_back_count = 0;
 
@@ -93,6 +94,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_processor &
 		state_blocks_count = block_processor.state_blocks.size ();
 		blocks_count = block_processor.blocks.size ();
 		blocks_hashes_count = block_processor.blocks_hashes.size ();
+		deferred_count = block_processor.deferred.size ();
 		forced_count = block_processor.forced.size ();
 		rolled_back_count = block_processor.rolled_back.size ();
 	}
@@ -101,6 +103,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_processor &
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "state_blocks", state_blocks_count, sizeof (decltype (block_processor.state_blocks)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "blocks", blocks_count, sizeof (decltype (block_processor.blocks)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "blocks_hashes", blocks_hashes_count, sizeof (decltype (block_processor.blocks_hashes)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "deferred", deferred_count, sizeof (decltype (block_processor.deferred)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "forced", forced_count, sizeof (decltype (block_processor.forced)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "rolled_back", rolled_back_count, sizeof (decltype (block_processor.rolled_back)::value_type) }));
 	composite->add_component (collect_seq_con_info (block_processor.generator, "generator"));
@@ -142,12 +145,15 @@ block_processor_thread ([this]() {
 	nano::thread_role::set (nano::thread_role::name::block_processing);
 	this->block_processor.process_blocks ();
 }),
+block_arrival (stats),
 online_reps (*this, config.online_weight_minimum.number ()),
+votes_cache (stats),
 vote_uniquer (block_uniquer),
 active (*this),
-confirmation_height_processor (pending_confirmation_height, store, ledger.stats, active, ledger.epoch_link, write_database_queue, config.conf_height_processor_batch_min_time, logger),
+confirmation_height_processor (pending_confirmation_height, store, ledger.stats, active, block_arrival, ledger.epoch_link, write_database_queue, config.conf_height_processor_batch_min_time, logger),
 payment_observer_processor (observers.blocks),
 wallets (wallets_store.init_error (), *this),
+vote_aggregator (*this),
 startup_time (std::chrono::steady_clock::now ())
 {
 	if (!init_error ())
@@ -333,7 +339,7 @@ startup_time (std::chrono::steady_clock::now ())
 					{
 						logger.try_log (boost::str (boost::format ("Found a representative at %1%") % channel_a->to_string ()));
 						// Rebroadcasting all active votes to new representative
-						auto blocks (this->active.list_blocks (true));
+						auto blocks (this->active.list_blocks ());
 						for (auto i (blocks.begin ()), n (blocks.end ()); i != n; ++i)
 						{
 							if (*i != nullptr)
@@ -543,25 +549,26 @@ void nano::node::process_fork (nano::transaction const & transaction_a, std::sha
 		if (ledger_block && !block_confirmed_or_being_confirmed (transaction_a, ledger_block->hash ()))
 		{
 			std::weak_ptr<nano::node> this_w (shared_from_this ());
-			if (!active.start (ledger_block, [this_w, root](std::shared_ptr<nano::block>) {
-				    if (auto this_l = this_w.lock ())
-				    {
-					    auto attempt (this_l->bootstrap_initiator.current_attempt ());
-					    if (attempt && attempt->mode == nano::bootstrap_mode::legacy)
-					    {
-						    auto transaction (this_l->store.tx_begin_read ());
-						    auto account (this_l->ledger.store.frontier_get (transaction, root));
-						    if (!account.is_zero ())
-						    {
-							    attempt->requeue_pull (nano::pull_info (account, root, root));
-						    }
-						    else if (this_l->ledger.store.account_exists (transaction, root))
-						    {
-							    attempt->requeue_pull (nano::pull_info (root, nano::block_hash (0), nano::block_hash (0)));
-						    }
-					    }
-				    }
-			    }))
+			auto result (active.start (ledger_block, [this_w, root](std::shared_ptr<nano::block>) {
+				if (auto this_l = this_w.lock ())
+				{
+					auto attempt (this_l->bootstrap_initiator.current_attempt ());
+					if (attempt && attempt->mode == nano::bootstrap_mode::legacy)
+					{
+						auto transaction (this_l->store.tx_begin_read ());
+						auto account (this_l->ledger.store.frontier_get (transaction, root));
+						if (!account.is_zero ())
+						{
+							attempt->requeue_pull (nano::pull_info (account, root, root));
+						}
+						else if (this_l->ledger.store.account_exists (transaction, root))
+						{
+							attempt->requeue_pull (nano::pull_info (root, nano::block_hash (0), nano::block_hash (0)));
+						}
+					}
+				}
+			}));
+			if (result == nano::election_start_result::started)
 			{
 				logger.always_log (boost::str (boost::format ("Resolving fork between our block: %1% and block %2% both with root %3%") % ledger_block->hash ().to_string () % block_a->hash ().to_string () % block_a->root ().to_string ()));
 				network.broadcast_confirm_req (ledger_block);
@@ -586,6 +593,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (node & node, const
 	composite->add_component (node.network.udp_channels.collect_seq_con_info ("udp_channels"));
 	composite->add_component (node.network.response_channels.collect_seq_con_info ("response_channels"));
 	composite->add_component (node.network.syn_cookies.collect_seq_con_info ("syn_cookies"));
+	composite->add_component (node.network.confirm_reqs.collect_seq_con_info ("confirm_req_scheduler"));
 	composite->add_component (collect_seq_con_info (node.observers, "observers"));
 	composite->add_component (collect_seq_con_info (node.wallets, "wallets"));
 	composite->add_component (collect_seq_con_info (node.vote_processor, "vote_processor"));
@@ -594,6 +602,7 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (node & node, const
 	composite->add_component (collect_seq_con_info (node.block_arrival, "block_arrival"));
 	composite->add_component (collect_seq_con_info (node.online_reps, "online_reps"));
 	composite->add_component (collect_seq_con_info (node.votes_cache, "votes_cache"));
+	composite->add_component (collect_seq_con_info (node.vote_aggregator, "vote_aggregator"));
 	composite->add_component (collect_seq_con_info (node.block_uniquer, "block_uniquer"));
 	composite->add_component (collect_seq_con_info (node.vote_uniquer, "vote_uniquer"));
 	composite->add_component (collect_seq_con_info (node.confirmation_height_processor, "confirmation_height_processor"));
@@ -680,6 +689,7 @@ void nano::node::stop ()
 			block_processor_thread.join ();
 		}
 		vote_processor.stop ();
+		vote_aggregator.stop ();
 		confirmation_height_processor.stop ();
 		active.stop ();
 		network.stop ();
@@ -1514,6 +1524,7 @@ void nano::node::process_confirmed (nano::election_status const & status_a, uint
 		nano::account pending_account (0);
 		process_confirmed_data (transaction, block_a, hash, sideband, account, amount, is_state_send, pending_account);
 		observers.blocks.notify (status_a, account, amount, is_state_send);
+		block_arrival.trace (hash, nano::block_stage::dispatched);
 		if (amount > 0)
 		{
 			observers.account_balance.notify (account, false);
@@ -1537,6 +1548,11 @@ void nano::node::process_confirmed (nano::election_status const & status_a, uint
 	}
 }
 
+nano::block_arrival::block_arrival (nano::stat & stats_a) :
+stats (stats_a)
+{
+}
+
 bool nano::block_arrival::add (nano::block_hash const & hash_a)
 {
 	std::lock_guard<std::mutex> lock (mutex);
@@ -1557,6 +1573,61 @@ bool nano::block_arrival::recent (nano::block_hash const & hash_a)
 	return arrival.get<1> ().find (hash_a) != arrival.get<1> ().end ();
 }
 
+void nano::block_arrival::trace (nano::block_hash const & hash_a, nano::block_stage stage_a)
+{
+	auto index (static_cast<size_t> (stage_a));
+	auto traced (false);
+	std::chrono::steady_clock::duration latency (0);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto existing (arrival.get<1> ().find (hash_a));
+		if (existing != arrival.get<1> ().end () && existing->stages[index] == std::chrono::steady_clock::time_point ())
+		{
+			auto now (std::chrono::steady_clock::now ());
+			arrival.get<1> ().modify (existing, [index, now](nano::block_arrival_info & info_a) {
+				info_a.stages[index] = now;
+			});
+			latency = now - existing->arrival;
+			traced = true;
+		}
+	}
+	if (traced)
+	{
+		auto type (nano::stat::type::latency_processed);
+		switch (stage_a)
+		{
+			case nano::block_stage::processed:
+				type = nano::stat::type::latency_processed;
+				break;
+			case nano::block_stage::election_started:
+				type = nano::stat::type::latency_election_started;
+				break;
+			case nano::block_stage::confirmed:
+				type = nano::stat::type::latency_confirmed;
+				break;
+			case nano::block_stage::cemented:
+				type = nano::stat::type::latency_cemented;
+				break;
+			case nano::block_stage::dispatched:
+				type = nano::stat::type::latency_dispatched;
+				break;
+		}
+		stats.add_latency (type, std::chrono::duration_cast<std::chrono::milliseconds> (latency));
+	}
+}
+
+bool nano::block_arrival::timings (nano::block_hash const & hash_a, nano::block_arrival_info & info_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (arrival.get<1> ().find (hash_a));
+	auto error (existing == arrival.get<1> ().end ());
+	if (!error)
+	{
+		info_a = *existing;
+	}
+	return error;
+}
+
 namespace nano
 {
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (block_arrival & block_arrival, const std::string & name)
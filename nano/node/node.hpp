@@ -35,6 +35,7 @@
 #include <boost/thread/latch.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
@@ -46,20 +47,37 @@ namespace nano
 class node;
 
 class work_pool;
+/** Points a live block passes on its way to confirmation, timed from its arrival */
+enum class block_stage : uint8_t
+{
+	processed,
+	election_started,
+	confirmed,
+	cemented,
+	dispatched
+};
 class block_arrival_info final
 {
 public:
 	std::chrono::steady_clock::time_point arrival;
 	nano::block_hash hash;
+	/** When each block_stage was reached, default constructed until then */
+	std::array<std::chrono::steady_clock::time_point, 5> stages;
 };
 // This class tracks blocks that are probably live because they arrived in a UDP packet
 // This gives a fairly reliable way to differentiate between blocks being inserted via bootstrap or new, live blocks.
 class block_arrival final
 {
 public:
+	block_arrival (nano::stat &);
 	// Return `true' to indicated an error if the block has already been inserted
 	bool add (nano::block_hash const &);
 	bool recent (nano::block_hash const &);
+	/** Records the first time a recently arrived block reaches \p stage_a and counts the time since arrival in the stage's latency histogram */
+	void trace (nano::block_hash const &, nano::block_stage);
+	// Return `true' to indicate an error if the block did not arrive recently
+	bool timings (nano::block_hash const &, nano::block_arrival_info &);
+	nano::stat & stats;
 	boost::multi_index_container<
 	nano::block_arrival_info,
 	boost::multi_index::indexed_by<
@@ -176,6 +194,7 @@ public:
 	nano::confirmation_height_processor confirmation_height_processor;
 	nano::payment_observer_processor payment_observer_processor;
 	nano::wallets wallets;
+	nano::vote_aggregator vote_aggregator;
 	const std::chrono::steady_clock::time_point startup_time;
 	std::chrono::seconds unchecked_cutoff = std::chrono::seconds (7 * 24 * 60 * 60); // Week
 	std::atomic<bool> unresponsive_work_peers{ false };
@@ -76,9 +76,12 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("network_threads", network_threads, "Number of threads dedicated to processing network messages\ntype:uint64");
 	toml.put ("work_threads", work_threads, "Number of threads dedicated to CPU generated work. Defaults to all available CPU threads.\ntype:uint64");
 	toml.put ("signature_checker_threads", signature_checker_threads, "Number of additional threads dedicated to signature verification\ntype:uint64");
+	toml.put ("vote_processor_threads", vote_processor_threads, "Number of threads applying incoming votes to elections\ntype:uint64");
 	toml.put ("enable_voting", enable_voting, "Enable or disable voting. Enabling voting requires additional system resources.\ntype:bool");
 	toml.put ("bootstrap_connections", bootstrap_connections, "Number of outbound bootstrap connections. Must be a power of 2.\ntype:uint64");
 	toml.put ("bootstrap_connections_max", bootstrap_connections_max, "Maximum number of inbound bootstrap connections\ntype:uint64");
+	toml.put ("bootstrap_serving_window", bootstrap_serving_window, "Number of blocks read ahead and written per batch when serving bootstrap requests\ntype:uint64,[1..]");
+	toml.put ("bootstrap_lazy_max_memory", bootstrap_lazy_max_memory, "Memory ceiling in MB for lazy bootstrap dependency tracking. The oldest entries are forgotten once it is reached\ntype:uint64,[1..]");
 	toml.put ("lmdb_max_dbs", lmdb_max_dbs, "Maximum open lmdb databases. Increase default if more than 100 wallets is required.\ntype:uint64");
 	toml.put ("block_processor_batch_max_time", block_processor_batch_max_time.count (), "The maximum time the block processor can process blocks at a time\ntype:milliseconds");
 	toml.put ("allow_local_peers", allow_local_peers, "Enable or disable local host peering\ntype:bool");
@@ -94,7 +97,11 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("use_memory_pools", use_memory_pools, "If true, allocate memory from memory pools. Enabling this may improve performance. Memory is never released to the OS.\ntype:bool");
 	toml.put ("confirmation_history_size", confirmation_history_size, "Maximum confirmation history size\ntype:uint64");
 	toml.put ("active_elections_size", active_elections_size, "Limits number of active elections before dropping will be considered (other conditions must also be satisfied)\ntype:uint64,[250..]");
+	toml.put ("active_elections_queue_size", active_elections_queue_size, "Maximum number of elections waiting for admission while active elections are full, the lowest priority are evicted beyond it\ntype:uint64");
 	toml.put ("bandwidth_limit", bandwidth_limit, "Outbound traffic limit in bytes/sec after which messages will be dropped\ntype:uint64");
+	toml.put ("bandwidth_limit_votes", bandwidth_limit_votes, "Outbound limit in bytes/sec for confirm_req and confirm_ack traffic, in addition to bandwidth_limit. 0 = no separate limit\ntype:uint64");
+	toml.put ("bandwidth_limit_blocks", bandwidth_limit_blocks, "Outbound limit in bytes/sec for publish traffic, in addition to bandwidth_limit. 0 = no separate limit\ntype:uint64");
+	toml.put ("bandwidth_limit_bootstrap", bandwidth_limit_bootstrap, "Outbound limit in bytes/sec for droppable bootstrap requests, in addition to bandwidth_limit. 0 = no separate limit\ntype:uint64");
 	toml.put ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time.count (), "Minimum write batching time when there are blocks pending confirmation height\ntype:milliseconds");
 	toml.put ("backup_before_upgrade", backup_before_upgrade, "Backup the ledger database before performing upgrades\ntype:bool");
 	toml.put ("work_watcher_period", work_watcher_period.count (), "Time between checks for confirmation and re-generating higher difficulty work if unconfirmed, for blocks in the work watcher.\ntype:seconds");
@@ -292,10 +299,13 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get<unsigned> ("network_threads", network_threads);
 		toml.get<unsigned> ("bootstrap_connections", bootstrap_connections);
 		toml.get<unsigned> ("bootstrap_connections_max", bootstrap_connections_max);
+		toml.get<unsigned> ("bootstrap_serving_window", bootstrap_serving_window);
+		toml.get<unsigned> ("bootstrap_lazy_max_memory", bootstrap_lazy_max_memory);
 		toml.get<int> ("lmdb_max_dbs", lmdb_max_dbs);
 		toml.get<bool> ("enable_voting", enable_voting);
 		toml.get<bool> ("allow_local_peers", allow_local_peers);
 		toml.get<unsigned> (signature_checker_threads_key, signature_checker_threads);
+		toml.get<unsigned> ("vote_processor_threads", vote_processor_threads);
 		toml.get<boost::asio::ip::address_v6> ("external_address", external_address);
 		toml.get<uint16_t> ("external_port", external_port);
 		toml.get<unsigned> ("tcp_incoming_connections_max", tcp_incoming_connections_max);
@@ -306,7 +316,11 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get<bool> ("use_memory_pools", use_memory_pools);
 		toml.get<size_t> ("confirmation_history_size", confirmation_history_size);
 		toml.get<size_t> ("active_elections_size", active_elections_size);
+		toml.get<size_t> ("active_elections_queue_size", active_elections_queue_size);
 		toml.get<size_t> ("bandwidth_limit", bandwidth_limit);
+		toml.get<size_t> ("bandwidth_limit_votes", bandwidth_limit_votes);
+		toml.get<size_t> ("bandwidth_limit_blocks", bandwidth_limit_blocks);
+		toml.get<size_t> ("bandwidth_limit_bootstrap", bandwidth_limit_bootstrap);
 		toml.get<bool> ("backup_before_upgrade", backup_before_upgrade);
 
 		auto work_watcher_period_l = work_watcher_period.count ();
@@ -340,6 +354,18 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		{
 			toml.get_error ().set ("io_threads must be non-zero");
 		}
+		if (vote_processor_threads == 0)
+		{
+			toml.get_error ().set ("vote_processor_threads must be non-zero");
+		}
+		if (bootstrap_serving_window == 0)
+		{
+			toml.get_error ().set ("bootstrap_serving_window must be non-zero");
+		}
+		if (bootstrap_lazy_max_memory == 0)
+		{
+			toml.get_error ().set ("bootstrap_lazy_max_memory must be non-zero");
+		}
 		if (active_elections_size <= 250 && !network.is_test_network ())
 		{
 			toml.get_error ().set ("active_elections_size must be greater than 250");
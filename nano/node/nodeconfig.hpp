@@ -58,9 +58,15 @@ public:
 	unsigned network_threads{ std::max<unsigned> (4, boost::thread::hardware_concurrency ()) };
 	unsigned work_threads{ std::max<unsigned> (4, boost::thread::hardware_concurrency ()) };
 	unsigned signature_checker_threads{ (boost::thread::hardware_concurrency () != 0) ? boost::thread::hardware_concurrency () - 1 : 0 }; /* The calling thread does checks as well so remove it from the number of threads used */
+	/** Votes for different elections are applied concurrently by these threads */
+	unsigned vote_processor_threads{ std::max<unsigned> (1, boost::thread::hardware_concurrency () / 4) };
 	bool enable_voting{ false };
 	unsigned bootstrap_connections{ 4 };
 	unsigned bootstrap_connections_max{ 64 };
+	/** Number of blocks read ahead under one transaction and written together when serving bootstrap requests */
+	unsigned bootstrap_serving_window{ 128 };
+	/** Memory ceiling in MB for the lazy bootstrap processed block filter and pending dependency maps */
+	unsigned bootstrap_lazy_max_memory{ 256 };
 	nano::websocket::config websocket_config;
 	nano::diagnostics_config diagnostics_config;
 	size_t confirmation_history_size{ 2048 };
@@ -81,6 +87,8 @@ public:
 	std::chrono::seconds tcp_io_timeout{ (network_params.network.is_test_network () && !is_sanitizer_build) ? std::chrono::seconds (5) : std::chrono::seconds (15) };
 	std::chrono::nanoseconds pow_sleep_interval{ 0 };
 	size_t active_elections_size{ 50000 };
+	/** Elections waiting for a free slot once active_elections_size is reached, ordered by difficulty */
+	size_t active_elections_queue_size{ 10000 };
 	/** Default maximum incoming TCP connections, including realtime network & bootstrap */
 	unsigned tcp_incoming_connections_max{ 1024 };
 	bool use_memory_pools{ true };
@@ -88,6 +96,10 @@ public:
 	static std::chrono::seconds constexpr keepalive_cutoff = keepalive_period * 5;
 	static std::chrono::minutes constexpr wallet_backup_interval = std::chrono::minutes (5);
 	size_t bandwidth_limit{ 5 * 1024 * 1024 }; // 5MB/s
+	/** Separate outbound budgets per traffic class, in bytes/sec. 0 = only bounded by bandwidth_limit */
+	size_t bandwidth_limit_votes{ 0 };
+	size_t bandwidth_limit_blocks{ 0 };
+	size_t bandwidth_limit_bootstrap{ 0 };
 	std::chrono::milliseconds conf_height_processor_batch_min_time{ 50 };
 	bool backup_before_upgrade{ false };
 	std::chrono::seconds work_watcher_period{ std::chrono::seconds (5) };
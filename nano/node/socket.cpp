@@ -59,6 +59,28 @@ void nano::socket::async_read (std::shared_ptr<std::vector<uint8_t>> buffer_a, s
 	}
 }
 
+void nano::socket::async_read_some (std::shared_ptr<std::vector<uint8_t>> buffer_a, size_t offset_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
+{
+	assert (offset_a < buffer_a->size ());
+	auto this_l (shared_from_this ());
+	if (!closed)
+	{
+		start_timer ();
+		boost::asio::post (strand, boost::asio::bind_executor (strand, [buffer_a, callback_a, offset_a, this_l]() {
+			this_l->tcp_socket.async_read_some (boost::asio::buffer (buffer_a->data () + offset_a, buffer_a->size () - offset_a),
+			boost::asio::bind_executor (this_l->strand,
+			[this_l, buffer_a, callback_a](boost::system::error_code const & ec, size_t size_a) {
+				if (auto node = this_l->node.lock ())
+				{
+					node->stats.add (nano::stat::type::traffic_tcp, nano::stat::dir::in, size_a);
+					this_l->stop_timer ();
+					callback_a (ec, size_a);
+				}
+			}));
+		}));
+	}
+}
+
 void nano::socket::async_write (std::shared_ptr<std::vector<uint8_t>> buffer_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
 {
 	auto this_l (shared_from_this ());
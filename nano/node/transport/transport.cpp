@@ -70,7 +70,7 @@ nano::tcp_endpoint nano::transport::map_endpoint_to_tcp (nano::endpoint const &
 }
 
 nano::transport::channel::channel (nano::node & node_a) :
-limiter (node_a.config.bandwidth_limit),
+limiter (node_a.config.bandwidth_limit, node_a.config.bandwidth_limit_votes, node_a.config.bandwidth_limit_blocks, node_a.config.bandwidth_limit_bootstrap),
 node (node_a)
 {
 	set_network_version (node_a.network_params.protocol.protocol_version);
@@ -82,7 +82,7 @@ void nano::transport::channel::send (nano::message const & message_a, std::funct
 	message_a.visit (visitor);
 	auto buffer (message_a.to_bytes ());
 	auto detail (visitor.result);
-	if (!is_droppable_a || !limiter.should_drop (buffer->size ()))
+	if (!is_droppable_a || !limiter.should_drop (nano::outbound_bandwidth_limiter::type_of (detail), buffer->size ()))
 	{
 		send_buffer (buffer, detail, callback_a);
 		node.stats.inc (nano::stat::type::message, detail, nano::stat::dir::out);
@@ -207,12 +207,28 @@ bool nano::transport::reserved_address (nano::endpoint const & endpoint_a, bool
 
 using namespace std::chrono_literals;
 
+namespace
+{
+std::chrono::nanoseconds constexpr bandwidth_trend_period = 50ms;
+}
+
 nano::bandwidth_limiter::bandwidth_limiter (const size_t limit_a) :
-next_trend (std::chrono::steady_clock::now () + 50ms),
 limit (limit_a),
-rate (0),
-trended_rate (0)
+burst_tolerance (std::chrono::duration_cast<std::chrono::nanoseconds> (bandwidth_trend_period).count ()),
+start (std::chrono::steady_clock::now ()),
+next_trend (burst_tolerance)
+{
+}
+
+uint64_t nano::bandwidth_limiter::cost (const size_t & message_size) const
+{
+	assert (limit != 0);
+	return static_cast<uint64_t> (message_size) * std::chrono::nanoseconds (1s).count () / limit;
+}
+
+uint64_t nano::bandwidth_limiter::elapsed () const
 {
+	return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start).count ();
 }
 
 bool nano::bandwidth_limiter::should_drop (const size_t & message_size)
@@ -222,28 +238,137 @@ bool nano::bandwidth_limiter::should_drop (const size_t & message_size)
 	{
 		return result;
 	}
-	std::lock_guard<std::mutex> lock (mutex);
-
-	if (message_size > limit / rate_buffer.size () || rate + message_size > limit)
+	auto now (elapsed ());
+	auto cost_l (cost (message_size));
+	// Messages larger than the burst capacity (limit / rate_buffer_size bytes) can never be sent
+	result = message_size > limit / rate_buffer_size;
+	auto arrival (theoretical_arrival.load ());
+	while (!result)
 	{
-		result = true;
+		auto next (std::max (arrival, now) + cost_l);
+		if (next > now + burst_tolerance)
+		{
+			result = true;
+		}
+		else if (theoretical_arrival.compare_exchange_weak (arrival, next))
+		{
+			break;
+		}
 	}
-	else
+	if (!result)
 	{
-		rate = rate + message_size;
+		rate += message_size;
 	}
-	if (next_trend < std::chrono::steady_clock::now ())
+	else
 	{
-		next_trend = std::chrono::steady_clock::now () + 50ms;
-		rate_buffer.push_back (rate);
-		trended_rate = std::accumulate (rate_buffer.begin (), rate_buffer.end (), size_t{ 0 }) / rate_buffer.size ();
-		rate = 0;
+		++drops;
 	}
+	trend (now);
 	return result;
 }
 
-size_t nano::bandwidth_limiter::get_rate ()
+void nano::bandwidth_limiter::refund (const size_t & message_size)
+{
+	if (limit != 0)
+	{
+		theoretical_arrival -= cost (message_size);
+		auto rate_l (rate.load ());
+		while (!rate.compare_exchange_weak (rate_l, rate_l - std::min (rate_l, message_size)))
+		{
+		}
+	}
+}
+
+void nano::bandwidth_limiter::trend (uint64_t now_a)
+{
+	auto next_trend_l (next_trend.load ());
+	// Only the thread advancing next_trend closes the current period
+	if (next_trend_l < now_a && next_trend.compare_exchange_strong (next_trend_l, now_a + burst_tolerance))
+	{
+		auto rate_l (rate.exchange (0));
+		auto old_rate (rate_buffer[rate_buffer_index++ % rate_buffer_size].exchange (rate_l));
+		rate_buffer_sum += rate_l;
+		rate_buffer_sum -= old_rate;
+		trended_rate = rate_buffer_sum / rate_buffer_size;
+	}
+}
+
+size_t nano::bandwidth_limiter::get_rate () const
 {
-	std::lock_guard<std::mutex> lock (mutex);
 	return trended_rate;
 }
+
+uint64_t nano::bandwidth_limiter::get_drops () const
+{
+	return drops;
+}
+
+nano::outbound_bandwidth_limiter::outbound_bandwidth_limiter (size_t limit_a, size_t votes_limit_a, size_t blocks_limit_a, size_t bootstrap_limit_a) :
+aggregate (limit_a)
+{
+	std::array<size_t, type_count> class_limits{ { votes_limit_a, blocks_limit_a, bootstrap_limit_a, 0 } };
+	for (size_t i (0); i < type_count; ++i)
+	{
+		// A limit this large never drops, but unlike 0 it still has the rate of the class tracked
+		limiters[i] = std::make_unique<nano::bandwidth_limiter> (class_limits[i] != 0 ? class_limits[i] : std::numeric_limits<size_t>::max ());
+	}
+}
+
+bool nano::outbound_bandwidth_limiter::should_drop (nano::bandwidth_limit_type type_a, const size_t & message_size)
+{
+	auto index (static_cast<size_t> (type_a));
+	auto & limiter (*limiters[index]);
+	bool result (limiter.should_drop (message_size));
+	if (!result)
+	{
+		result = aggregate.should_drop (message_size);
+		if (result)
+		{
+			limiter.refund (message_size);
+		}
+	}
+	if (result)
+	{
+		++drops[index];
+	}
+	return result;
+}
+
+size_t nano::outbound_bandwidth_limiter::get_rate () const
+{
+	return aggregate.get_rate ();
+}
+
+size_t nano::outbound_bandwidth_limiter::get_rate (nano::bandwidth_limit_type type_a) const
+{
+	return limiters[static_cast<size_t> (type_a)]->get_rate ();
+}
+
+uint64_t nano::outbound_bandwidth_limiter::get_drops (nano::bandwidth_limit_type type_a) const
+{
+	return drops[static_cast<size_t> (type_a)];
+}
+
+nano::bandwidth_limit_type nano::outbound_bandwidth_limiter::type_of (nano::stat::detail detail_a)
+{
+	auto result (nano::bandwidth_limit_type::other);
+	switch (detail_a)
+	{
+		case nano::stat::detail::confirm_req:
+		case nano::stat::detail::confirm_ack:
+			result = nano::bandwidth_limit_type::votes;
+			break;
+		case nano::stat::detail::publish:
+			result = nano::bandwidth_limit_type::blocks;
+			break;
+		case nano::stat::detail::bulk_pull:
+		case nano::stat::detail::bulk_pull_account:
+		case nano::stat::detail::bulk_push:
+		case nano::stat::detail::frontier_req:
+			result = nano::bandwidth_limit_type::bootstrap;
+			break;
+		default:
+			break;
+	}
+	return result;
+}
@@ -4,30 +4,81 @@
 #include <nano/node/common.hpp>
 #include <nano/node/socket.hpp>
 
+#include <array>
+#include <atomic>
 #include <unordered_set>
 
 namespace nano
 {
+/**
+ * Lock-free token bucket limiting outbound traffic to a number of bytes per second.
+ * The bucket is tracked as a single theoretical arrival time (GCRA), which is advanced by the cost of
+ * every accepted message with a compare-and-swap, so no mutex is taken on the send path.
+ */
 class bandwidth_limiter final
 {
 public:
 	// initialize with rate 0 = unbounded
 	bandwidth_limiter (const size_t);
 	bool should_drop (const size_t &);
-	size_t get_rate ();
+	/** Returns the budget taken by an accepted message of the given size, e.g. when a further limit drops it */
+	void refund (const size_t &);
+	size_t get_rate () const;
+	uint64_t get_drops () const;
 
 private:
-	//last time rate was adjusted
-	std::chrono::steady_clock::time_point next_trend;
-	//trend rate over 20 poll periods
-	boost::circular_buffer<size_t> rate_buffer{ 20, 0 };
+	uint64_t cost (const size_t &) const;
+	uint64_t elapsed () const;
+	void trend (uint64_t);
+	static size_t constexpr rate_buffer_size = 20;
 	//limit bandwidth to
 	const size_t limit;
-	//rate, increment if message_size + rate < rate
-	size_t rate;
+	//how far ahead of now the bucket can be filled, i.e. the burst capacity expressed in time
+	const uint64_t burst_tolerance;
+	//theoretical arrival time of the next message in nanoseconds since the limiter was created
+	std::atomic<uint64_t> theoretical_arrival{ 0 };
+	std::chrono::steady_clock::time_point const start;
+	//next time rate is adjusted, in nanoseconds since the limiter was created
+	std::atomic<uint64_t> next_trend;
+	//trend rate over 20 poll periods
+	std::array<std::atomic<size_t>, rate_buffer_size> rate_buffer{};
+	std::atomic<size_t> rate_buffer_index{ 0 };
+	std::atomic<size_t> rate_buffer_sum{ 0 };
+	//rate of the current poll period
+	std::atomic<size_t> rate{ 0 };
 	//trended rate to even out spikes in traffic
-	size_t trended_rate;
-	std::mutex mutex;
+	std::atomic<size_t> trended_rate{ 0 };
+	std::atomic<uint64_t> drops{ 0 };
+};
+
+/** Classes of outbound traffic which can be given separate bandwidth budgets */
+enum class bandwidth_limit_type : uint8_t
+{
+	votes,
+	blocks,
+	bootstrap,
+	other
+};
+
+/**
+ * Limits outbound traffic of a channel with an aggregate budget, optionally capping each traffic class with its own budget.
+ * A class limit of 0 means the class is only bounded by the aggregate limit.
+ */
+class outbound_bandwidth_limiter final
+{
+public:
+	outbound_bandwidth_limiter (size_t, size_t = 0, size_t = 0, size_t = 0);
+	bool should_drop (nano::bandwidth_limit_type, const size_t &);
+	size_t get_rate () const;
+	size_t get_rate (nano::bandwidth_limit_type) const;
+	uint64_t get_drops (nano::bandwidth_limit_type) const;
+	static nano::bandwidth_limit_type type_of (nano::stat::detail);
+
+private:
+	static size_t constexpr type_count = static_cast<size_t> (nano::bandwidth_limit_type::other) + 1;
+	nano::bandwidth_limiter aggregate;
+	std::array<std::unique_ptr<nano::bandwidth_limiter>, type_count> limiters;
+	std::array<std::atomic<uint64_t>, type_count> drops{};
 };
 namespace transport
 {
@@ -133,7 +184,7 @@ namespace transport
 		}
 
 		mutable std::mutex channel_mutex;
-		nano::bandwidth_limiter limiter;
+		nano::outbound_bandwidth_limiter limiter;
 
 	private:
 		std::chrono::steady_clock::time_point last_bootstrap_attempt{ std::chrono::steady_clock::time_point () };
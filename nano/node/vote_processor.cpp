@@ -6,12 +6,15 @@ nano::vote_processor::vote_processor (nano::node & node_a) :
 node (node_a),
 started (false),
 stopped (false),
-active (false),
-thread ([this]() {
-	nano::thread_role::set (nano::thread_role::name::vote_processing);
-	process_loop ();
-})
+active (0)
 {
+	for (auto i (0u); i < threads_count (); ++i)
+	{
+		threads.push_back (boost::thread ([this]() {
+			nano::thread_role::set (nano::thread_role::name::vote_processing);
+			process_loop ();
+		}));
+	}
 	std::unique_lock<std::mutex> lock (mutex);
 	while (!started)
 	{
@@ -19,6 +22,11 @@ thread ([this]() {
 	}
 }
 
+unsigned nano::vote_processor::threads_count () const
+{
+	return std::max (1u, node.config.vote_processor_threads);
+}
+
 void nano::vote_processor::process_loop ()
 {
 	nano::timer<std::chrono::milliseconds> elapsed;
@@ -36,7 +44,21 @@ void nano::vote_processor::process_loop ()
 		if (!votes.empty ())
 		{
 			std::deque<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> votes_l;
-			votes_l.swap (votes);
+			if (threads_count () == 1)
+			{
+				votes_l.swap (votes);
+			}
+			else
+			{
+				// Leave a share of the queue to the other threads
+				auto count (std::max<size_t> (1, votes.size () / threads_count ()));
+				votes_l.insert (votes_l.end (), std::make_move_iterator (votes.begin ()), std::make_move_iterator (votes.begin () + count));
+				votes.erase (votes.begin (), votes.begin () + count);
+				if (!votes.empty ())
+				{
+					condition.notify_one ();
+				}
+			}
 
 			log_this_iteration = false;
 			if (node.config.logging.network_logging () && votes_l.size () > 50)
@@ -48,28 +70,26 @@ void nano::vote_processor::process_loop ()
 				log_this_iteration = true;
 				elapsed.start ();
 			}
-			active = true;
+			++active;
 			lock.unlock ();
 			verify_votes (votes_l);
 			{
-				std::unique_lock<std::mutex> active_single_lock (node.active.mutex);
+				// Votes are applied without node.active.mutex, elections lock themselves
 				auto transaction (node.store.tx_begin_read ());
 				uint64_t count (1);
 				for (auto & i : votes_l)
 				{
 					vote_blocking (transaction, i.first, i.second, true);
-					// Free active_transactions mutex each 100 processed votes
+					// Refresh the read transaction each 100 processed votes
 					if (count % 100 == 0)
 					{
-						active_single_lock.unlock ();
 						transaction.refresh ();
-						active_single_lock.lock ();
 					}
 					count++;
 				}
 			}
 			lock.lock ();
-			active = false;
+			--active;
 
 			lock.unlock ();
 			condition.notify_all ();
@@ -176,16 +196,15 @@ void nano::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<na
 	votes_a.swap (result);
 }
 
-// node.active.mutex lock required
+// node.active.mutex must not be held, it is taken to look up elections and by the vote observers
 nano::vote_code nano::vote_processor::vote_blocking (nano::transaction const & transaction_a, std::shared_ptr<nano::vote> vote_a, std::shared_ptr<nano::transport::channel> channel_a, bool validated)
 {
-	assert (!node.active.mutex.try_lock ());
 	auto result (nano::vote_code::invalid);
 	if (validated || !vote_a->validate ())
 	{
 		auto max_vote (node.store.vote_max (transaction_a, vote_a));
 		result = nano::vote_code::replay;
-		if (!node.active.vote (vote_a, true))
+		if (!node.active.vote (vote_a))
 		{
 			result = nano::vote_code::vote;
 		}
@@ -238,9 +257,12 @@ void nano::vote_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
-	if (thread.joinable ())
+	for (auto & thread : threads)
 	{
-		thread.join ();
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
 	}
 }
 
@@ -10,6 +10,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_set>
+#include <vector>
 
 namespace nano
 {
@@ -25,7 +26,7 @@ class vote_processor final
 public:
 	explicit vote_processor (nano::node &);
 	void vote (std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>);
-	/** Note: node.active.mutex lock is required */
+	/** Note: node.active.mutex must not be held */
 	nano::vote_code vote_blocking (nano::transaction const &, std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>, bool = false);
 	void verify_votes (std::deque<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> &);
 	void flush ();
@@ -35,6 +36,7 @@ public:
 
 private:
 	void process_loop ();
+	unsigned threads_count () const;
 	std::deque<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> votes;
 	/** Representatives levels for random early detection */
 	std::unordered_set<nano::account> representatives_1;
@@ -44,8 +46,9 @@ private:
 	std::mutex mutex;
 	bool started;
 	bool stopped;
-	bool active;
-	boost::thread thread;
+	/** Number of threads processing a batch */
+	unsigned active;
+	std::vector<boost::thread> threads;
 
 	friend std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_processor & vote_processor, const std::string & name);
 };
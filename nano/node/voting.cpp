@@ -1,8 +1,12 @@
 #include <nano/node/node.hpp>
 #include <nano/node/voting.hpp>
 
+#include <algorithm>
 #include <chrono>
 
+size_t constexpr nano::vote_aggregator::max_hashes;
+size_t constexpr nano::vote_aggregator::max_queue;
+
 nano::vote_generator::vote_generator (nano::node & node_a) :
 node (node_a),
 thread ([this]() { run (); })
@@ -89,29 +93,164 @@ void nano::vote_generator::run ()
 	}
 }
 
+nano::vote_aggregator::vote_aggregator (nano::node & node_a) :
+node (node_a),
+thread ([this]() { run (); })
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	while (!started)
+	{
+		condition.wait (lock);
+	}
+}
+
+void nano::vote_aggregator::add (std::shared_ptr<nano::transport::channel> channel_a, std::vector<nano::block_hash> const & hashes_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	for (auto & hash : hashes_a)
+	{
+		auto existing (requesters.find (hash));
+		if (existing == requesters.end ())
+		{
+			if (hashes.size () < max_queue)
+			{
+				hashes.push_back (hash);
+				requesters.emplace (hash, std::vector<std::shared_ptr<nano::transport::channel>> (1, channel_a));
+			}
+			else
+			{
+				node.stats.inc (nano::stat::type::drop, nano::stat::detail::confirm_req, nano::stat::dir::in);
+			}
+		}
+		else if (std::find (existing->second.begin (), existing->second.end (), channel_a) == existing->second.end ())
+		{
+			existing->second.push_back (channel_a);
+		}
+	}
+	lock.unlock ();
+	condition.notify_all ();
+}
+
+void nano::vote_aggregator::stop ()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	stopped = true;
+
+	lock.unlock ();
+	condition.notify_all ();
+
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+size_t nano::vote_aggregator::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return hashes.size ();
+}
+
+void nano::vote_aggregator::reply (std::unique_lock<std::mutex> & lock_a)
+{
+	std::vector<nano::block_hash> hashes_l;
+	std::vector<std::shared_ptr<nano::transport::channel>> channels_l;
+	hashes_l.reserve (max_hashes);
+	while (!hashes.empty () && hashes_l.size () < max_hashes)
+	{
+		auto existing (requesters.find (hashes.front ()));
+		assert (existing != requesters.end ());
+		for (auto & channel : existing->second)
+		{
+			if (std::find (channels_l.begin (), channels_l.end (), channel) == channels_l.end ())
+			{
+				channels_l.push_back (channel);
+			}
+		}
+		hashes_l.push_back (existing->first);
+		requesters.erase (existing);
+		hashes.pop_front ();
+	}
+	lock_a.unlock ();
+	{
+		auto transaction (node.store.tx_begin_read ());
+		node.wallets.foreach_representative (transaction, [this, &hashes_l, &channels_l, &transaction](nano::public_key const & pub_a, nano::raw_key const & prv_a) {
+			auto vote (this->node.store.vote_generate (transaction, pub_a, prv_a, hashes_l));
+			this->node.stats.inc (nano::stat::type::vote, nano::stat::detail::vote_generated);
+			this->node.votes_cache.add (vote);
+			nano::confirm_ack confirm (vote);
+			for (auto & channel : channels_l)
+			{
+				channel->send (confirm);
+			}
+		});
+	}
+	lock_a.lock ();
+}
+
+void nano::vote_aggregator::run ()
+{
+	nano::thread_role::set (nano::thread_role::name::voting);
+	std::unique_lock<std::mutex> lock (mutex);
+	started = true;
+	lock.unlock ();
+	condition.notify_all ();
+	lock.lock ();
+	while (!stopped)
+	{
+		if (hashes.empty ())
+		{
+			condition.wait (lock);
+		}
+		else
+		{
+			if (hashes.size () < max_hashes)
+			{
+				// Give other peers asking for votes a chance to share the signature
+				condition.wait_for (lock, node.config.vote_generator_delay, [this]() { return this->stopped || this->hashes.size () >= max_hashes; });
+			}
+			reply (lock);
+		}
+	}
+}
+
+nano::votes_cache::votes_cache (nano::stat & stats_a) :
+stats (stats_a),
+shards (std::max<size_t> (1, network_params.voting.cache_shards)),
+shard_max_bytes (network_params.voting.max_cache * entry_size (1) / shards.size ())
+{
+}
+
+size_t nano::votes_cache::entry_size (size_t votes_a)
+{
+	return sizeof (nano::cached_votes) + votes_a * (sizeof (std::shared_ptr<nano::vote>) + sizeof (nano::vote));
+}
+
+nano::votes_cache::shard & nano::votes_cache::shard_for (nano::block_hash const & hash_a)
+{
+	return shards[hash_a.qwords[0] % shards.size ()];
+}
+
 void nano::votes_cache::add (std::shared_ptr<nano::vote> const & vote_a)
 {
-	std::lock_guard<std::mutex> lock (cache_mutex);
 	for (auto & block : vote_a->blocks)
 	{
 		auto hash (boost::get<nano::block_hash> (block));
-		auto existing (cache.get<1> ().find (hash));
-		if (existing == cache.get<1> ().end ())
+		auto & shard (shard_for (hash));
+		std::lock_guard<std::mutex> lock (shard.mutex);
+		auto existing (shard.cache.get<1> ().find (hash));
+		if (existing == shard.cache.get<1> ().end ())
 		{
-			// Clean old votes
-			if (cache.size () >= network_params.voting.max_cache)
-			{
-				cache.erase (cache.begin ());
-			}
 			// Insert new votes (new hash)
-			auto inserted (cache.insert (nano::cached_votes{ std::chrono::steady_clock::now (), hash, std::vector<std::shared_ptr<nano::vote>> (1, vote_a) }));
+			auto inserted (shard.cache.insert (nano::cached_votes{ std::chrono::steady_clock::now (), hash, std::vector<std::shared_ptr<nano::vote>> (1, vote_a) }));
 			(void)inserted;
 			assert (inserted.second);
+			shard.bytes += entry_size (1);
 		}
 		else
 		{
 			// Insert new votes (old hash)
-			cache.get<1> ().modify (existing, [vote_a](nano::cached_votes & cache_a) {
+			shard.cache.get<1> ().modify (existing, [&shard, vote_a](nano::cached_votes & cache_a) {
 				// Replace old vote for same representative & hash
 				bool replaced (false);
 				for (auto i (cache_a.votes.begin ()), n (cache_a.votes.end ()); i != n && !replaced; ++i)
@@ -126,28 +265,68 @@ void nano::votes_cache::add (std::shared_ptr<nano::vote> const & vote_a)
 				if (!replaced)
 				{
 					cache_a.votes.push_back (vote_a);
+					shard.bytes += entry_size (cache_a.votes.size ()) - entry_size (cache_a.votes.size () - 1);
 				}
 			});
 		}
+		// Clean old votes
+		while (shard.bytes > shard_max_bytes && shard.cache.size () > 1)
+		{
+			shard.bytes -= entry_size (shard.cache.begin ()->votes.size ());
+			shard.cache.erase (shard.cache.begin ());
+			stats.inc (nano::stat::type::vote, nano::stat::detail::vote_cache_evict);
+		}
 	}
 }
 
 std::vector<std::shared_ptr<nano::vote>> nano::votes_cache::find (nano::block_hash const & hash_a)
 {
 	std::vector<std::shared_ptr<nano::vote>> result;
-	std::lock_guard<std::mutex> lock (cache_mutex);
-	auto existing (cache.get<1> ().find (hash_a));
-	if (existing != cache.get<1> ().end ())
 	{
-		result = existing->votes;
+		auto & shard (shard_for (hash_a));
+		std::lock_guard<std::mutex> lock (shard.mutex);
+		auto existing (shard.cache.get<1> ().find (hash_a));
+		if (existing != shard.cache.get<1> ().end ())
+		{
+			result = existing->votes;
+		}
 	}
+	stats.inc (nano::stat::type::vote, result.empty () ? nano::stat::detail::vote_cache_miss : nano::stat::detail::vote_cache_hit);
 	return result;
 }
 
 void nano::votes_cache::remove (nano::block_hash const & hash_a)
 {
-	std::lock_guard<std::mutex> lock (cache_mutex);
-	cache.get<1> ().erase (hash_a);
+	auto & shard (shard_for (hash_a));
+	std::lock_guard<std::mutex> lock (shard.mutex);
+	auto existing (shard.cache.get<1> ().find (hash_a));
+	if (existing != shard.cache.get<1> ().end ())
+	{
+		shard.bytes -= entry_size (existing->votes.size ());
+		shard.cache.get<1> ().erase (existing);
+	}
+}
+
+size_t nano::votes_cache::size ()
+{
+	size_t result (0);
+	for (auto & shard : shards)
+	{
+		std::lock_guard<std::mutex> lock (shard.mutex);
+		result += shard.cache.size ();
+	}
+	return result;
+}
+
+size_t nano::votes_cache::size_bytes ()
+{
+	size_t result (0);
+	for (auto & shard : shards)
+	{
+		std::lock_guard<std::mutex> lock (shard.mutex);
+		result += shard.bytes;
+	}
+	return result;
 }
 
 namespace nano
@@ -166,15 +345,24 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_generator & v
 	return composite;
 }
 
-std::unique_ptr<seq_con_info_component> collect_seq_con_info (votes_cache & votes_cache, const std::string & name)
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_aggregator & vote_aggregator, const std::string & name)
 {
-	size_t cache_count = 0;
+	size_t hashes_count = 0;
 
 	{
-		std::lock_guard<std::mutex> guard (votes_cache.cache_mutex);
-		cache_count = votes_cache.cache.size ();
+		std::lock_guard<std::mutex> guard (vote_aggregator.mutex);
+		hashes_count = vote_aggregator.hashes.size ();
 	}
-	auto sizeof_element = sizeof (decltype (votes_cache.cache)::value_type);
+	auto sizeof_element = sizeof (decltype (vote_aggregator.requesters)::value_type);
+	auto composite = std::make_unique<seq_con_info_composite> (name);
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "requests", hashes_count, sizeof_element }));
+	return composite;
+}
+
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (votes_cache & votes_cache, const std::string & name)
+{
+	auto cache_count (votes_cache.size ());
+	auto sizeof_element = sizeof (nano::cached_votes);
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	/* This does not currently loop over each element inside the cache to get the sizes of the votes inside cached_votes */
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "cache", cache_count, sizeof_element }));
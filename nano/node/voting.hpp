@@ -15,10 +15,16 @@
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <unordered_map>
 
 namespace nano
 {
 class node;
+class stat;
+namespace transport
+{
+	class channel;
+}
 class vote_generator final
 {
 public:
@@ -42,6 +48,39 @@ private:
 };
 
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_generator & vote_generator, const std::string & name);
+/**
+ * Collects hashes peers request votes for over a short window so that a single vote per representative covers
+ * up to max_hashes hashes and is sent to every peer that asked for any of them
+ */
+class vote_aggregator final
+{
+public:
+	vote_aggregator (nano::node &);
+	void add (std::shared_ptr<nano::transport::channel>, std::vector<nano::block_hash> const &);
+	void stop ();
+	size_t size ();
+	static size_t constexpr max_hashes = 12;
+	/** Requested hashes waiting for a vote, further hashes are dropped */
+	static size_t constexpr max_queue = 16 * 1024;
+
+private:
+	void run ();
+	void reply (std::unique_lock<std::mutex> &);
+	nano::node & node;
+	std::mutex mutex;
+	std::condition_variable condition;
+	/** Requested hashes in arrival order */
+	std::deque<nano::block_hash> hashes;
+	/** Channels waiting on each requested hash */
+	std::unordered_map<nano::block_hash, std::vector<std::shared_ptr<nano::transport::channel>>> requesters;
+	bool stopped{ false };
+	bool started{ false };
+	boost::thread thread;
+
+	friend std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_aggregator & vote_aggregator, const std::string & name);
+};
+
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_aggregator & vote_aggregator, const std::string & name);
 class cached_votes final
 {
 public:
@@ -49,23 +88,41 @@ public:
 	nano::block_hash hash;
 	std::vector<std::shared_ptr<nano::vote>> votes;
 };
+/**
+ * Votes by block hash, a vote covering several hashes is found under each of them.
+ * Entries are spread over shards by hash, each with its own lock and an equal part of the memory budget, oldest entries are evicted first.
+ */
 class votes_cache final
 {
 public:
+	votes_cache (nano::stat &);
 	void add (std::shared_ptr<nano::vote> const &);
 	std::vector<std::shared_ptr<nano::vote>> find (nano::block_hash const &);
 	void remove (nano::block_hash const &);
+	size_t size ();
+	/** Approximate memory used by the cached entries */
+	size_t size_bytes ();
+	/** Approximate memory used by an entry holding \p votes_a votes */
+	static size_t entry_size (size_t votes_a);
 
 private:
-	std::mutex cache_mutex;
-	boost::multi_index_container<
-	nano::cached_votes,
-	boost::multi_index::indexed_by<
-	boost::multi_index::ordered_non_unique<boost::multi_index::member<nano::cached_votes, std::chrono::steady_clock::time_point, &nano::cached_votes::time>>,
-	boost::multi_index::hashed_unique<boost::multi_index::member<nano::cached_votes, nano::block_hash, &nano::cached_votes::hash>>>>
-	cache;
+	class shard final
+	{
+	public:
+		std::mutex mutex;
+		boost::multi_index_container<
+		nano::cached_votes,
+		boost::multi_index::indexed_by<
+		boost::multi_index::ordered_non_unique<boost::multi_index::member<nano::cached_votes, std::chrono::steady_clock::time_point, &nano::cached_votes::time>>,
+		boost::multi_index::hashed_unique<boost::multi_index::member<nano::cached_votes, nano::block_hash, &nano::cached_votes::hash>>>>
+		cache;
+		size_t bytes{ 0 };
+	};
+	shard & shard_for (nano::block_hash const &);
+	nano::stat & stats;
 	nano::network_params network_params;
-	friend std::unique_ptr<seq_con_info_component> collect_seq_con_info (votes_cache & votes_cache, const std::string & name);
+	std::vector<shard> shards;
+	size_t shard_max_bytes;
 };
 
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (votes_cache & votes_cache, const std::string & name);
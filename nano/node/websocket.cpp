@@ -5,6 +5,7 @@
 #include <boost/property_tree/json_parser.hpp>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 
 nano::websocket::confirmation_options::confirmation_options (nano::node & node_a) :
@@ -18,6 +19,7 @@ node (node_a)
 	// Non-account filtering options
 	include_block = options_a.get<bool> ("include_block", true);
 	include_election_info = options_a.get<bool> ("include_election_info", false);
+	include_latency = options_a.get<bool> ("include_latency", false);
 
 	confirmation_types = 0;
 	auto type_l (options_a.get<std::string> ("confirmation_type", "all"));
@@ -508,8 +510,10 @@ void nano::websocket::listener::broadcast_confirmation (std::shared_ptr<nano::bl
 	nano::websocket::message_builder builder;
 
 	std::lock_guard<std::mutex> lk (sessions_mutex);
-	boost::optional<nano::websocket::message> msg_with_block;
-	boost::optional<nano::websocket::message> msg_without_block;
+	// One message per combination of include_block and include_latency, built on first use
+	std::array<std::array<boost::optional<nano::websocket::message>, 2>, 2> messages;
+	nano::block_arrival_info timings;
+	auto untraced (node.block_arrival.timings (block_a->hash (), timings));
 	for (auto & weak_session : sessions)
 	{
 		auto session_ptr (weak_session.lock ());
@@ -524,22 +528,14 @@ void nano::websocket::listener::broadcast_confirmation (std::shared_ptr<nano::bl
 				{
 					conf_options = &default_options;
 				}
-				auto include_block (conf_options == nullptr ? true : conf_options->get_include_block ());
-
-				if (include_block && !msg_with_block)
-				{
-					msg_with_block = builder.block_confirmed (block_a, account_a, amount_a, subtype, include_block, election_status_a, *conf_options);
-				}
-				else if (!include_block && !msg_without_block)
+				auto include_block (conf_options->get_include_block ());
+				auto & message (messages[include_block][conf_options->get_include_latency ()]);
+				if (!message)
 				{
-					msg_without_block = builder.block_confirmed (block_a, account_a, amount_a, subtype, include_block, election_status_a, *conf_options);
-				}
-				else
-				{
-					assert (false);
+					message = builder.block_confirmed (block_a, account_a, amount_a, subtype, include_block, election_status_a, *conf_options, untraced ? nullptr : &timings);
 				}
 
-				session_ptr->write (include_block ? msg_with_block.get () : msg_without_block.get ());
+				session_ptr->write (message.get ());
 			}
 		}
 	}
@@ -582,7 +578,7 @@ nano::websocket::message nano::websocket::message_builder::stopped_election (nan
 	return message_l;
 }
 
-nano::websocket::message nano::websocket::message_builder::block_confirmed (std::shared_ptr<nano::block> block_a, nano::account const & account_a, nano::amount const & amount_a, std::string subtype, bool include_block_a, nano::election_status const & election_status_a, nano::websocket::confirmation_options const & options_a)
+nano::websocket::message nano::websocket::message_builder::block_confirmed (std::shared_ptr<nano::block> block_a, nano::account const & account_a, nano::amount const & amount_a, std::string subtype, bool include_block_a, nano::election_status const & election_status_a, nano::websocket::confirmation_options const & options_a, nano::block_arrival_info const * timings_a)
 {
 	nano::websocket::message message_l (nano::websocket::topic::confirmation);
 	set_common_fields (message_l);
@@ -619,6 +615,21 @@ nano::websocket::message nano::websocket::message_builder::block_confirmed (std:
 		message_node_l.add_child ("election_info", election_node_l);
 	}
 
+	if (options_a.get_include_latency () && timings_a != nullptr)
+	{
+		// Milliseconds since arrival for each stage reached so far
+		std::array<char const *, 5> const names = { "processed", "election_started", "confirmed", "cemented", "dispatched" };
+		boost::property_tree::ptree latency_node_l;
+		for (size_t i (0); i < names.size (); ++i)
+		{
+			if (timings_a->stages[i] != std::chrono::steady_clock::time_point ())
+			{
+				latency_node_l.add (names[i], std::chrono::duration_cast<std::chrono::milliseconds> (timings_a->stages[i] - timings_a->arrival).count ());
+			}
+		}
+		message_node_l.add_child ("latency", latency_node_l);
+	}
+
 	if (include_block_a)
 	{
 		boost::property_tree::ptree block_node_l;
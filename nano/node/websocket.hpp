@@ -32,6 +32,7 @@ using socket_type = boost::asio::basic_stream_socket<boost::asio::ip::tcp, boost
 namespace nano
 {
 class node;
+class block_arrival_info;
 enum class election_status_type : uint8_t;
 namespace websocket
 {
@@ -79,7 +80,7 @@ namespace websocket
 	class message_builder final
 	{
 	public:
-		message block_confirmed (std::shared_ptr<nano::block> block_a, nano::account const & account_a, nano::amount const & amount_a, std::string subtype, bool include_block, nano::election_status const & election_status_a, nano::websocket::confirmation_options const & options_a);
+		message block_confirmed (std::shared_ptr<nano::block> block_a, nano::account const & account_a, nano::amount const & amount_a, std::string subtype, bool include_block, nano::election_status const & election_status_a, nano::websocket::confirmation_options const & options_a, nano::block_arrival_info const * timings_a = nullptr);
 		message stopped_election (nano::block_hash const & hash_a);
 		message vote_received (std::shared_ptr<nano::vote> vote_a);
 		message difficulty_changed (uint64_t publish_threshold, uint64_t difficulty_active);
@@ -140,6 +141,12 @@ namespace websocket
 			return include_election_info;
 		}
 
+		/** Returns whether or not to include the time since arrival each stage of the block's confirmation was reached at */
+		bool get_include_latency () const
+		{
+			return include_latency;
+		}
+
 		static constexpr const uint8_t type_active_quorum = 1;
 		static constexpr const uint8_t type_active_confirmation_height = 2;
 		static constexpr const uint8_t type_inactive = 4;
@@ -149,6 +156,7 @@ namespace websocket
 	private:
 		nano::node & node;
 		bool include_election_info{ false };
+		bool include_latency{ false };
 		bool include_block{ true };
 		bool has_account_filtering_options{ false };
 		bool all_local_accounts{ false };
@@ -3703,6 +3703,38 @@ TEST (rpc, bootstrap_any)
 	ASSERT_TRUE (success.empty ());
 }
 
+TEST (rpc, bootstrap_scores)
+{
+	nano::system system (24000, 1);
+	auto & node = system.nodes.front ();
+	nano::tcp_endpoint endpoint (boost::asio::ip::address_v6::loopback (), 10000);
+	node->bootstrap_initiator.peer_scores.pulled (endpoint, 100, 0, std::chrono::seconds (2), true);
+	scoped_io_thread_name_change scoped_thread_name_io;
+	enable_ipc_transport_tcp (node->config.ipc_config.transport_tcp);
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config (true);
+	nano::ipc_rpc_processor ipc_rpc_processor (system.io_ctx, rpc_config);
+	nano::rpc rpc (system.io_ctx, rpc_config, ipc_rpc_processor);
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "bootstrap_scores");
+	test_response response (request, rpc.config.port, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response.status);
+	auto & peers_node (response.json.get_child ("peers"));
+	ASSERT_EQ (1, peers_node.size ());
+	auto & entry (peers_node.begin ()->second);
+	ASSERT_EQ (50.0, entry.get<double> ("block_rate"));
+	ASSERT_EQ ("1", entry.get<std::string> ("requests"));
+	ASSERT_EQ ("0", entry.get<std::string> ("failures"));
+	ASSERT_TRUE (entry.get<bool> ("usable"));
+}
+
 TEST (rpc, republish)
 {
 	nano::system system (24000, 2);
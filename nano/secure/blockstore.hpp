@@ -80,6 +80,16 @@ public:
 		convert_buffer_to_value ();
 	}
 
+	db_val (nano::pull_checkpoint const & val_a) :
+	buffer (std::make_shared<std::vector<uint8_t>> ())
+	{
+		{
+			nano::vectorstream stream (*buffer);
+			val_a.serialize (stream);
+		}
+		convert_buffer_to_value ();
+	}
+
 	db_val (nano::block_info const & val_a) :
 	db_val (sizeof (val_a), const_cast<nano::block_info *> (&val_a))
 	{
@@ -176,6 +186,16 @@ public:
 		return result;
 	}
 
+	explicit operator nano::pull_checkpoint () const
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
+		nano::pull_checkpoint result;
+		bool error (result.deserialize (stream));
+		(void)error;
+		assert (!error);
+		return result;
+	}
+
 	explicit operator nano::uint128_union () const
 	{
 		nano::uint128_union result;
@@ -483,6 +503,7 @@ enum class tables
 	accounts_v0,
 	accounts_v1,
 	blocks_info, // LMDB only
+	bootstrap,
 	cached_counts, // RocksDB only
 	change_blocks,
 	confirmation_height,
@@ -670,6 +691,16 @@ public:
 	virtual nano::store_iterator<nano::endpoint_key, nano::no_value> peers_begin (nano::transaction const & transaction_a) const = 0;
 	virtual nano::store_iterator<nano::endpoint_key, nano::no_value> peers_end () const = 0;
 
+	virtual void bootstrap_pull_put (nano::write_transaction const &, nano::account const &, nano::pull_checkpoint const &) = 0;
+	virtual size_t bootstrap_pull_count (nano::transaction const &) const = 0;
+	virtual void bootstrap_pull_clear (nano::write_transaction const &) = 0;
+	virtual nano::store_iterator<nano::account, nano::pull_checkpoint> bootstrap_pull_begin (nano::transaction const &) const = 0;
+	virtual nano::store_iterator<nano::account, nano::pull_checkpoint> bootstrap_pull_end () const = 0;
+	/** Highest account whose frontier comparison has completed, kept in the meta table */
+	virtual void bootstrap_frontier_put (nano::write_transaction const &, nano::account const &) = 0;
+	virtual bool bootstrap_frontier_get (nano::transaction const &, nano::account &) const = 0;
+	virtual void bootstrap_frontier_del (nano::write_transaction const &) = 0;
+
 	virtual void confirmation_height_put (nano::write_transaction const & transaction_a, nano::account const & account_a, uint64_t confirmation_height_a) = 0;
 	virtual bool confirmation_height_get (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t & confirmation_height_a) = 0;
 	virtual bool confirmation_height_exists (nano::transaction const & transaction_a, nano::account const & account_a) const = 0;
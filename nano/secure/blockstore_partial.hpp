@@ -349,6 +349,11 @@ public:
 		return nano::store_iterator<nano::pending_key, nano::pending_info> (nullptr);
 	}
 
+	nano::store_iterator<nano::account, nano::pull_checkpoint> bootstrap_pull_end () const override
+	{
+		return nano::store_iterator<nano::account, nano::pull_checkpoint> (nullptr);
+	}
+
 	nano::store_iterator<uint64_t, nano::amount> online_weight_end () const override
 	{
 		return nano::store_iterator<uint64_t, nano::amount> (nullptr);
@@ -697,6 +702,52 @@ public:
 		release_assert (success (status));
 	}
 
+	void bootstrap_pull_put (nano::write_transaction const & transaction_a, nano::account const & account_a, nano::pull_checkpoint const & pull_a) override
+	{
+		nano::db_val<Val> value (pull_a);
+		auto status (put (transaction_a, tables::bootstrap, account_a, value));
+		release_assert (success (status));
+	}
+
+	size_t bootstrap_pull_count (nano::transaction const & transaction_a) const override
+	{
+		return count (transaction_a, tables::bootstrap);
+	}
+
+	void bootstrap_pull_clear (nano::write_transaction const & transaction_a) override
+	{
+		auto status (drop (transaction_a, tables::bootstrap));
+		release_assert (success (status));
+	}
+
+	void bootstrap_frontier_put (nano::write_transaction const & transaction_a, nano::account const & account_a) override
+	{
+		nano::uint256_union frontier_key (2);
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (frontier_key), nano::db_val<Val> (account_a)));
+		release_assert (success (status));
+	}
+
+	bool bootstrap_frontier_get (nano::transaction const & transaction_a, nano::account & account_a) const override
+	{
+		nano::uint256_union frontier_key (2);
+		nano::db_val<Val> data;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (frontier_key), data));
+		release_assert (success (status) || not_found (status));
+		auto result (not_found (status));
+		if (!result)
+		{
+			account_a = nano::uint256_union (data);
+		}
+		return result;
+	}
+
+	void bootstrap_frontier_del (nano::write_transaction const & transaction_a) override
+	{
+		nano::uint256_union frontier_key (2);
+		auto status (del (transaction_a, tables::meta, nano::db_val<Val> (frontier_key)));
+		release_assert (success (status) || not_found (status));
+	}
+
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a) const
 	{
 		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
@@ -891,6 +942,11 @@ public:
 		return make_iterator<nano::endpoint_key, nano::no_value> (transaction_a, tables::peers);
 	}
 
+	nano::store_iterator<nano::account, nano::pull_checkpoint> bootstrap_pull_begin (nano::transaction const & transaction_a) const override
+	{
+		return make_iterator<nano::account, nano::pull_checkpoint> (transaction_a, tables::bootstrap);
+	}
+
 	nano::store_iterator<nano::account, uint64_t> confirmation_height_begin (nano::transaction const & transaction_a, nano::account const & account_a) override
 	{
 		return make_iterator<nano::account, uint64_t> (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a));
@@ -910,7 +966,7 @@ protected:
 	nano::network_params network_params;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l1;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l2;
-	static int constexpr version{ 15 };
+	static int constexpr version{ 16 };
 
 	template <typename T>
 	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a, tables table_a)
@@ -120,6 +120,7 @@ nano::node_constants::node_constants (nano::network_constants & network_constant
 nano::voting_constants::voting_constants (nano::network_constants & network_constants)
 {
 	max_cache = network_constants.is_test_network () ? 2 : 4 * 1024;
+	cache_shards = network_constants.is_test_network () ? 1 : 16;
 }
 
 nano::portmapping_constants::portmapping_constants (nano::network_constants & network_constants)
@@ -332,6 +333,47 @@ bool nano::unchecked_info::deserialize (nano::stream & stream_a)
 	return error;
 }
 
+nano::pull_checkpoint::pull_checkpoint (nano::block_hash const & head_a, nano::block_hash const & head_original_a, nano::block_hash const & end_a, uint32_t count_a, uint64_t processed_a) :
+head (head_a),
+head_original (head_original_a),
+end (end_a),
+count (count_a),
+processed (processed_a)
+{
+}
+
+void nano::pull_checkpoint::serialize (nano::stream & stream_a) const
+{
+	nano::write (stream_a, head.bytes);
+	nano::write (stream_a, head_original.bytes);
+	nano::write (stream_a, end.bytes);
+	nano::write (stream_a, count);
+	nano::write (stream_a, processed);
+}
+
+bool nano::pull_checkpoint::deserialize (nano::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		nano::read (stream_a, head.bytes);
+		nano::read (stream_a, head_original.bytes);
+		nano::read (stream_a, end.bytes);
+		nano::read (stream_a, count);
+		nano::read (stream_a, processed);
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
+bool nano::pull_checkpoint::operator== (nano::pull_checkpoint const & other_a) const
+{
+	return head == other_a.head && head_original == other_a.head_original && end == other_a.end && count == other_a.count && processed == other_a.processed;
+}
+
 nano::endpoint_key::endpoint_key (const std::array<uint8_t, 16> & address_a, uint16_t port_a) :
 address (address_a), network_port (boost::endian::native_to_big (port_a))
 {
@@ -440,40 +482,7 @@ nano::vote::vote (bool & error_a, nano::stream & stream_a, nano::block_uniquer *
 
 nano::vote::vote (bool & error_a, nano::stream & stream_a, nano::block_type type_a, nano::block_uniquer * uniquer_a)
 {
-	try
-	{
-		nano::read (stream_a, account.bytes);
-		nano::read (stream_a, signature.bytes);
-		nano::read (stream_a, sequence);
-
-		while (stream_a.in_avail () > 0)
-		{
-			if (type_a == nano::block_type::not_a_block)
-			{
-				nano::block_hash block_hash;
-				nano::read (stream_a, block_hash);
-				blocks.push_back (block_hash);
-			}
-			else
-			{
-				std::shared_ptr<nano::block> block (nano::deserialize_block (stream_a, type_a, uniquer_a));
-				if (block == nullptr)
-				{
-					throw std::runtime_error ("Block is null");
-				}
-				blocks.push_back (block);
-			}
-		}
-	}
-	catch (std::runtime_error const &)
-	{
-		error_a = true;
-	}
-
-	if (blocks.empty ())
-	{
-		error_a = true;
-	}
+	error_a = deserialize (stream_a, type_a, uniquer_a);
 }
 
 nano::vote::vote (nano::account const & account_a, nano::raw_key const & prv_a, uint64_t sequence_a, std::shared_ptr<nano::block> block_a) :
@@ -537,7 +546,8 @@ nano::uint256_union nano::vote::full_hash () const
 	nano::uint256_union result;
 	blake2b_state state;
 	blake2b_init (&state, sizeof (result.bytes));
-	blake2b_update (&state, hash ().bytes.data (), sizeof (hash ().bytes));
+	auto hash_l (hash ());
+	blake2b_update (&state, hash_l.bytes.data (), sizeof (hash_l.bytes));
 	blake2b_update (&state, account.bytes.data (), sizeof (account.bytes.data ()));
 	blake2b_update (&state, signature.bytes.data (), sizeof (signature.bytes.data ()));
 	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
@@ -639,6 +649,47 @@ bool nano::vote::deserialize (nano::stream & stream_a, nano::block_uniquer * uni
 	return error;
 }
 
+bool nano::vote::deserialize (nano::stream & stream_a, nano::block_type type_a, nano::block_uniquer * uniquer_a)
+{
+	auto error (false);
+	try
+	{
+		nano::read (stream_a, account.bytes);
+		nano::read (stream_a, signature.bytes);
+		nano::read (stream_a, sequence);
+
+		while (stream_a.in_avail () > 0)
+		{
+			if (type_a == nano::block_type::not_a_block)
+			{
+				nano::block_hash block_hash;
+				nano::read (stream_a, block_hash);
+				blocks.push_back (block_hash);
+			}
+			else
+			{
+				std::shared_ptr<nano::block> block (nano::deserialize_block (stream_a, type_a, uniquer_a));
+				if (block == nullptr)
+				{
+					throw std::runtime_error ("Block is null");
+				}
+				blocks.push_back (block);
+			}
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+
+	if (blocks.empty ())
+	{
+		error = true;
+	}
+
+	return error;
+}
+
 bool nano::vote::validate () const
 {
 	return nano::validate_message (account, hash (), signature);
@@ -682,50 +733,62 @@ std::shared_ptr<nano::vote> nano::vote_uniquer::unique (std::shared_ptr<nano::vo
 		{
 			result->blocks.front () = uniquer.unique (boost::get<std::shared_ptr<nano::block>> (result->blocks.front ()));
 		}
-		nano::uint256_union key (vote_a->full_hash ());
-		std::lock_guard<std::mutex> lock (mutex);
-		auto & existing (votes[key]);
-		if (auto block_l = existing.lock ())
-		{
-			result = block_l;
-		}
-		else
-		{
-			existing = vote_a;
-		}
+		result = unique (vote_a->full_hash (), vote_a);
+	}
+	return result;
+}
 
-		release_assert (std::numeric_limits<CryptoPP::word32>::max () > votes.size ());
-		for (auto i (0); i < cleanup_count && !votes.empty (); ++i)
-		{
-			auto random_offset = nano::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (votes.size () - 1));
+std::shared_ptr<nano::vote> nano::vote_uniquer::find (nano::uint256_union const & full_hash_a)
+{
+	return votes.find (full_hash_a);
+}
 
-			auto existing (std::next (votes.begin (), random_offset));
-			if (existing == votes.end ())
-			{
-				existing = votes.begin ();
-			}
-			if (existing != votes.end ())
-			{
-				if (auto block_l = existing->second.lock ())
-				{
-					// Still live
-				}
-				else
-				{
-					votes.erase (existing);
-				}
-			}
+std::shared_ptr<nano::vote> nano::vote_uniquer::deserialize (bool & error_a, nano::stream & stream_a, nano::block_type type_a)
+{
+	// Reused by every call on this thread, only promoted to a shared vote when it escapes the parser
+	static thread_local nano::vote vote_l;
+	vote_l.blocks.clear ();
+	error_a = vote_l.deserialize (stream_a, type_a, &uniquer);
+	std::shared_ptr<nano::vote> result;
+	if (!error_a)
+	{
+		auto key (vote_l.full_hash ());
+		result = find (key);
+		if (result == nullptr)
+		{
+			result = unique (key, nano::make_shared<nano::vote> (vote_l));
 		}
 	}
+	else
+	{
+		result = nano::make_shared<nano::vote> (vote_l);
+	}
+	// Blocks must not be kept alive by the thread local vote
+	vote_l.blocks.clear ();
 	return result;
 }
 
+std::shared_ptr<nano::vote> nano::vote_uniquer::unique (nano::uint256_union const & key, std::shared_ptr<nano::vote> vote_a)
+{
+	assert (vote_a != nullptr);
+	return votes.unique (key, vote_a);
+}
+
 size_t nano::vote_uniquer::size ()
 {
-	std::lock_guard<std::mutex> lock (mutex);
 	return votes.size ();
 }
 
+uint64_t nano::vote_uniquer::hits () const
+{
+	return votes.hits ();
+}
+
+uint64_t nano::vote_uniquer::misses () const
+{
+	return votes.misses ();
+}
+
 namespace nano
 {
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_uniquer & vote_uniquer, const std::string & name)
@@ -173,6 +173,24 @@ public:
 	nano::signature_verification verified{ nano::signature_verification::unknown };
 };
 
+/**
+ * Progress of an outstanding bootstrap pull, checkpointed so an interrupted bootstrap can resume
+ */
+class pull_checkpoint final
+{
+public:
+	pull_checkpoint () = default;
+	pull_checkpoint (nano::block_hash const &, nano::block_hash const &, nano::block_hash const &, uint32_t, uint64_t);
+	void serialize (nano::stream &) const;
+	bool deserialize (nano::stream &);
+	bool operator== (nano::pull_checkpoint const &) const;
+	nano::block_hash head{ 0 };
+	nano::block_hash head_original{ 0 };
+	nano::block_hash end{ 0 };
+	uint32_t count{ 0 };
+	uint64_t processed{ 0 };
+};
+
 class block_info final
 {
 public:
@@ -217,6 +235,8 @@ public:
 	void serialize (nano::stream &) const;
 	void serialize_json (boost::property_tree::ptree & tree) const;
 	bool deserialize (nano::stream &, nano::block_uniquer * = nullptr);
+	/** Deserialize blocks of \p type, as sent in confirm_ack messages */
+	bool deserialize (nano::stream &, nano::block_type, nano::block_uniquer * = nullptr);
 	bool validate () const;
 	boost::transform_iterator<nano::iterate_vote_blocks_as_hash, nano::vote_blocks_vec_iter> begin () const;
 	boost::transform_iterator<nano::iterate_vote_blocks_as_hash, nano::vote_blocks_vec_iter> end () const;
@@ -241,13 +261,22 @@ public:
 
 	vote_uniquer (nano::block_uniquer &);
 	std::shared_ptr<nano::vote> unique (std::shared_ptr<nano::vote>);
+	/** Same as unique (vote) with the full hash of the vote already computed */
+	std::shared_ptr<nano::vote> unique (nano::uint256_union const &, std::shared_ptr<nano::vote>);
+	/** Returns the live vote with this full hash, or nullptr if there is none */
+	std::shared_ptr<nano::vote> find (nano::uint256_union const &);
+	/**
+	 * Deserializes a vote into thread local storage and only allocates a shared vote if it's not already known.
+	 * The returned vote is not null if error is set, so it can be inspected in the same way as a newly constructed one.
+	 */
+	std::shared_ptr<nano::vote> deserialize (bool &, nano::stream &, nano::block_type);
 	size_t size ();
+	uint64_t hits () const;
+	uint64_t misses () const;
 
 private:
 	nano::block_uniquer & uniquer;
-	std::mutex mutex;
-	std::unordered_map<std::remove_const_t<value_type::first_type>, value_type::second_type> votes;
-	static unsigned constexpr cleanup_count = 2;
+	nano::sharded_uniquer<nano::uint256_union, nano::vote> votes;
 };
 
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (vote_uniquer & vote_uniquer, const std::string & name);
@@ -376,7 +405,9 @@ class voting_constants
 {
 public:
 	voting_constants (nano::network_constants & network_constants);
+	/** Votes cache budget, in entries holding a single vote */
 	size_t max_cache;
+	size_t cache_shards;
 };
 
 /** Port-mapping related constants whose value depends on the active network */
@@ -5,10 +5,33 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <thread>
 
 using namespace std::chrono_literals;
 
+namespace
+{
+/** Heap allocations made by the current thread, used to measure allocations per parsed packet */
+thread_local uint64_t thread_allocations{ 0 };
+}
+
+void * operator new (size_t size_a)
+{
+	++thread_allocations;
+	auto result (std::malloc (size_a != 0 ? size_a : 1));
+	if (result == nullptr)
+	{
+		throw std::bad_alloc ();
+	}
+	return result;
+}
+
+void operator delete (void * ptr_a) noexcept
+{
+	std::free (ptr_a);
+}
+
 TEST (system, generate_mass_activity)
 {
 	nano::system system;
@@ -726,6 +749,9 @@ TEST (confirmation_height, prioritize_frontiers_overwrite)
 		auto transaction = node->store.tx_begin_write ();
 		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send).code);
 		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, open).code);
+		// Frontier confirmation is disabled so the block processor does not update the index
+		node->active.add_uncemented (transaction, nano::test_genesis_key.pub);
+		node->active.add_uncemented (transaction, key.pub);
 	}
 	transaction.refresh ();
 	node->active.prioritize_frontiers_for_confirmation (transaction, std::chrono::seconds (60), std::chrono::seconds (60));
@@ -739,6 +765,8 @@ TEST (confirmation_height, prioritize_frontiers_overwrite)
 		auto transaction = node->store.tx_begin_write ();
 		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send1).code);
 		ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, receive).code);
+		node->active.add_uncemented (transaction, nano::test_genesis_key.pub);
+		node->active.add_uncemented (transaction, key.pub);
 	}
 
 	// Confirm that it gets replaced
@@ -756,3 +784,142 @@ TEST (confirmation_height, prioritize_frontiers_overwrite)
 	}
 }
 }
+
+// Applies votes for many elections from an increasing number of threads and reports votes per second
+TEST (active_transactions, vote_throughput)
+{
+	nano::system system;
+	nano::node_config node_config (24000, system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto & node (*system.add_node (node_config));
+	size_t const elections_count (1000);
+	size_t const reps_per_round (20);
+	std::array<unsigned, 4> const threads_counts{ 1, 2, 4, 8 };
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	std::vector<nano::block_hash> hashes;
+	for (size_t i (0); i < elections_count; ++i)
+	{
+		nano::keypair key;
+		blocks.push_back (std::make_shared<nano::state_block> (key.pub, 0, key.pub, 1, i + 1, key.prv, key.pub, system.work.generate (key.pub)));
+		hashes.push_back (blocks.back ()->hash ());
+	}
+	// Votes are signed up front, each round uses new representatives so no vote is a replay. Representatives without weight never reach quorum, so every vote is applied and none confirms an election
+	std::vector<std::vector<std::shared_ptr<nano::vote>>> rounds;
+	for (size_t round (0); round < threads_counts.size (); ++round)
+	{
+		rounds.emplace_back ();
+		for (size_t i (0); i < reps_per_round; ++i)
+		{
+			nano::keypair rep;
+			for (size_t j (0); j < elections_count; j += 12)
+			{
+				std::vector<nano::block_hash> vote_hashes (hashes.begin () + j, hashes.begin () + std::min<size_t> (j + 12, elections_count));
+				rounds.back ().push_back (std::make_shared<nano::vote> (rep.pub, rep.prv, 1, vote_hashes));
+			}
+		}
+	}
+	for (auto & block : blocks)
+	{
+		ASSERT_EQ (nano::election_start_result::started, node.active.start (block));
+	}
+	for (size_t round (0); round < threads_counts.size (); ++round)
+	{
+		auto & votes (rounds[round]);
+		std::atomic<size_t> next (0);
+		std::vector<std::thread> threads;
+		auto begin (std::chrono::steady_clock::now ());
+		for (auto i (0u); i < threads_counts[round]; ++i)
+		{
+			threads.emplace_back ([&node, &votes, &next]() {
+				for (auto index (next++); index < votes.size (); index = next++)
+				{
+					node.active.vote (votes[index]);
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+		std::cerr << boost::str (boost::format ("%1% threads: %2% votes/s\n") % threads_counts[round] % (votes.size () * 1000000ULL / std::max<uint64_t> (1, elapsed.count ())));
+	}
+	std::lock_guard<std::mutex> guard (node.active.mutex);
+	for (auto & hash : hashes)
+	{
+		auto existing (node.active.blocks.find (hash));
+		ASSERT_NE (node.active.blocks.end (), existing);
+		ASSERT_EQ (1 + threads_counts.size () * reps_per_round, existing->second->last_votes_size ());
+	}
+}
+
+namespace
+{
+class parser_benchmark_visitor : public nano::message_visitor
+{
+public:
+	void keepalive (nano::keepalive const &) override
+	{
+	}
+	void publish (nano::publish const &) override
+	{
+		++count;
+	}
+	void confirm_req (nano::confirm_req const &) override
+	{
+	}
+	void confirm_ack (nano::confirm_ack const &) override
+	{
+		++count;
+	}
+	void bulk_pull (nano::bulk_pull const &) override
+	{
+	}
+	void bulk_pull_account (nano::bulk_pull_account const &) override
+	{
+	}
+	void bulk_push (nano::bulk_push const &) override
+	{
+	}
+	void frontier_req (nano::frontier_req const &) override
+	{
+	}
+	void node_id_handshake (nano::node_id_handshake const &) override
+	{
+	}
+	uint64_t count{ 0 };
+};
+}
+
+// Parses the same packets repeatedly, as happens when a block or vote is flooded by many peers, and reports allocations per packet
+TEST (message_parser, duplicate_packet_allocations)
+{
+	nano::system system (24000, 1);
+	parser_benchmark_visitor visitor;
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	nano::message_parser parser (block_uniquer, vote_uniquer, visitor, system.work);
+	nano::keypair key;
+	auto block (std::make_shared<nano::state_block> (key.pub, 0, key.pub, 1, 2, key.prv, key.pub, system.work.generate (key.pub)));
+	std::vector<nano::block_hash> hashes (12, block->hash ());
+	auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, hashes));
+	std::vector<std::shared_ptr<std::vector<uint8_t>>> packets{ nano::publish (block).to_bytes (), nano::confirm_ack (vote).to_bytes () };
+	size_t const iterations (100000);
+	for (auto & packet : packets)
+	{
+		// Warm up, the first parse promotes the decoded object to a shared one
+		parser.deserialize_buffer (packet->data (), packet->size ());
+		ASSERT_EQ (parser.status, nano::message_parser::parse_status::success);
+		auto allocations_begin (thread_allocations);
+		auto begin (std::chrono::steady_clock::now ());
+		for (size_t i (0); i < iterations; ++i)
+		{
+			parser.deserialize_buffer (packet->data (), packet->size ());
+		}
+		auto elapsed (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+		auto allocations (thread_allocations - allocations_begin);
+		std::cerr << boost::str (boost::format ("Message type %1%: %2% allocations/packet, %3% ns/packet\n") % static_cast<unsigned> (packet->at (5)) % (static_cast<double> (allocations) / iterations) % (elapsed.count () / iterations));
+		ASSERT_LT (allocations, iterations);
+	}
+	ASSERT_EQ (2 * (iterations + 1), visitor.count);
+}